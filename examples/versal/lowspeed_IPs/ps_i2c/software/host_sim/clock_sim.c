@@ -0,0 +1,167 @@
+/******************************************************************************
+* Copyright (C) 2021 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file clock_sim.c
+*
+* Simulated time. By default the clock is virtual: it only moves when the
+* simulation spends time, for the bus conditions and bytes clocked out by a
+* controller, a delay, a WFI or a read of the global timer, and it moves at
+* once. A run takes the simulated time it reports but finishes as fast as
+* the host computes it, and the same run gives the same times every time.
+*
+* With the IICPS_SIM_CLOCK environment variable set to "wall" the simulated
+* time is the monotonic clock of the host instead, and spending time waits
+* for it to pass.
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "iic_sim.h"
+
+/************************** Constant Definitions *****************************/
+
+/*
+ * Waits on the wall clock shorter than this are spun, longer ones mostly
+ * slept.
+ */
+#define SIM_CLOCK_SPIN_NS	200000U
+
+/************************** Variable Definitions *****************************/
+
+static u64 VirtualNs;		/* Virtual time */
+static u32 ClockMode;		/* 0 until IicSim_IsWallClock() is called */
+
+/************************** Function Definitions *****************************/
+
+/*****************************************************************************/
+/**
+* Returns the monotonic clock of the host, relative to the first call.
+*
+******************************************************************************/
+static u64 IicSim_HostNs(void)
+{
+	static struct timespec Origin;
+	struct timespec Now;
+
+	clock_gettime(CLOCK_MONOTONIC, &Now);
+	if ((Origin.tv_sec == 0) && (Origin.tv_nsec == 0)) {
+		Origin = Now;
+	}
+
+	return (u64)(Now.tv_sec - Origin.tv_sec) * 1000000000U +
+		(u64)(Now.tv_nsec - Origin.tv_nsec);
+}
+
+/*****************************************************************************/
+/**
+* Returns TRUE if the simulated time is the wall clock.
+*
+******************************************************************************/
+static u32 IicSim_IsWallClock(void)
+{
+	const char *Env;
+
+	if (ClockMode == 0U) {
+		Env = getenv("IICPS_SIM_CLOCK");
+		ClockMode = ((Env != NULL) && (strcmp(Env, "wall") == 0)) ?
+			    2U : 1U;
+		(void)IicSim_HostNs();
+	}
+
+	return (ClockMode == 2U);
+}
+
+/*****************************************************************************/
+/**
+* Returns the time elapsed since the simulator started.
+*
+* @param	None.
+*
+* @return	Time in nanoseconds.
+*
+* @note		None.
+*
+******************************************************************************/
+u64 IicSim_NowNs(void)
+{
+	if (IicSim_IsWallClock() != FALSE) {
+		return IicSim_HostNs();
+	}
+
+	return VirtualNs;
+}
+
+/*****************************************************************************/
+/**
+* Returns the time elapsed since the simulator started.
+*
+* @param	None.
+*
+* @return	Time in microseconds.
+*
+* @note		None.
+*
+******************************************************************************/
+u64 IicSim_NowUs(void)
+{
+	return IicSim_NowNs() / 1000U;
+}
+
+/*****************************************************************************/
+/**
+* Returns the time the host took to run the simulation so far, which is the
+* simulated time as well with IICPS_SIM_CLOCK set to "wall".
+*
+* @param	None.
+*
+* @return	Time in microseconds.
+*
+* @note		None.
+*
+******************************************************************************/
+u64 IicSim_HostUs(void)
+{
+	(void)IicSim_IsWallClock();
+
+	return IicSim_HostNs() / 1000U;
+}
+
+/*****************************************************************************/
+/**
+* Lets the simulated time move on by the given amount.
+*
+* @param	Ns is the time in nanoseconds.
+*
+* @return	None.
+*
+* @note		On the wall clock this waits.
+*
+******************************************************************************/
+void IicSim_AdvanceNs(u64 Ns)
+{
+	struct timespec Delay;
+	u64 EndNs;
+
+	if (IicSim_IsWallClock() == FALSE) {
+		VirtualNs += Ns;
+		return;
+	}
+
+	EndNs = IicSim_HostNs() + Ns;
+	if (Ns > SIM_CLOCK_SPIN_NS) {
+		Delay.tv_sec = (time_t)((Ns - SIM_CLOCK_SPIN_NS) / 1000000000U);
+		Delay.tv_nsec = (long)((Ns - SIM_CLOCK_SPIN_NS) % 1000000000U);
+		nanosleep(&Delay, NULL);
+	}
+
+	while (IicSim_HostNs() < EndNs) {
+	}
+}
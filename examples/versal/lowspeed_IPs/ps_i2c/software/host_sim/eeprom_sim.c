@@ -0,0 +1,262 @@
+/******************************************************************************
+* Copyright (C) 2021 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file eeprom_sim.c
+*
+* Model of an M24xx/24Cxx class serial EEPROM.
+*
+* The model follows the datasheet behaviour the examples depend on:
+* - the word address is one or two bytes and sets the internal pointer,
+* - written bytes are latched in a page buffer and roll over within the page,
+* - the write cycle only starts on a STOP; a repeated START discards the
+*   latched bytes, so an address-only write never programs anything,
+* - the device does not acknowledge its address for the duration of the
+*   internal write cycle (tWR),
+* - reads auto-increment the pointer across the whole array,
+* - parts with more than 256 (or 65536) bytes behind a one (or two) byte
+*   word address take the upper address bits from the low bits of the slave
+*   address, so the part answers a block of slave addresses.
+*
+* The geometry and write cycle time come from a vendor profile, see
+* EepromSim_FindProfile().
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "xil_printf.h"
+#include "iic_sim.h"
+
+/************************** Constant Definitions *****************************/
+
+#define EEPROM_SIM_MAX_PAGE	256U
+
+/************************** Variable Definitions *****************************/
+
+/*
+ * Datasheet geometry and maximum tWR of the supported parts.
+ */
+static const EepromSim_Profile EepromSim_Profiles[] = {
+	{"M24C02",    256U, 16U, 1U, 0U, 5000U},
+	{"M24C08",   1024U, 16U, 1U, 2U, 5000U},
+	{"24C64",    8192U, 32U, 2U, 0U, 5000U},
+	{"M24128",  16384U, 64U, 2U, 0U, 5000U},
+};
+
+/**************************** Type Definitions *******************************/
+
+typedef enum {
+	EEPROM_SIM_IDLE,
+	EEPROM_SIM_ADDRESS,
+	EEPROM_SIM_DATA,
+	EEPROM_SIM_READ,
+} EepromSim_State;
+
+typedef struct {
+	IicSim_Device Dev;
+	u8 *Mem;		/* Array contents */
+	u32 Size;		/* Capacity in bytes */
+	u32 PageSize;		/* Page buffer size in bytes */
+	u32 AddrBytes;		/* Word address length */
+	u32 Block;		/* Block selected by the slave address */
+	u32 WriteCycleUs;	/* Internal write cycle time, tWR */
+
+	EepromSim_State State;
+	u32 Pointer;		/* Internal address counter */
+	u32 AddrCount;		/* Word address bytes received */
+	u32 NewPointer;		/* Word address being received */
+	u8 PageBuf[EEPROM_SIM_MAX_PAGE];
+	u8 Latched[EEPROM_SIM_MAX_PAGE];
+	u32 LatchedCount;
+	u64 BusyUntilUs;	/* End of the running write cycle */
+
+	u32 WriteCycles;	/* Write cycles started */
+	u32 BusyNacks;		/* Addresses refused during tWR */
+	u64 BusyTimeUs;		/* Accumulated write cycle time */
+} EepromSim;
+
+/************************** Function Definitions *****************************/
+
+static u32 EepromSim_Start(IicSim_Device *Dev, u16 SlaveAddr, u32 IsRead)
+{
+	EepromSim *Eeprom = Dev->Priv;
+
+	if (IicSim_NowUs() < Eeprom->BusyUntilUs) {
+		Eeprom->BusyNacks++;
+		return FALSE;
+	}
+
+	Eeprom->Block = SlaveAddr & Dev->AddrMask;
+
+	if (IsRead != FALSE) {
+		Eeprom->State = EEPROM_SIM_READ;
+	} else {
+		Eeprom->State = EEPROM_SIM_ADDRESS;
+		Eeprom->AddrCount = 0U;
+		Eeprom->NewPointer = 0U;
+		Eeprom->LatchedCount = 0U;
+		memset(Eeprom->Latched, 0, sizeof(Eeprom->Latched));
+	}
+
+	return TRUE;
+}
+
+static u32 EepromSim_Write(IicSim_Device *Dev, u8 Data)
+{
+	EepromSim *Eeprom = Dev->Priv;
+	u32 Offset;
+
+	if (Eeprom->State == EEPROM_SIM_ADDRESS) {
+		Eeprom->NewPointer = (Eeprom->NewPointer << 8) | Data;
+		if (++Eeprom->AddrCount == Eeprom->AddrBytes) {
+			Eeprom->Pointer = ((Eeprom->Block <<
+					    (8U * Eeprom->AddrBytes)) |
+					   Eeprom->NewPointer) % Eeprom->Size;
+			Eeprom->State = EEPROM_SIM_DATA;
+		}
+		return TRUE;
+	}
+
+	if (Eeprom->State != EEPROM_SIM_DATA) {
+		return FALSE;
+	}
+
+	/*
+	 * Data bytes roll over within the page addressed by the pointer.
+	 */
+	Offset = Eeprom->Pointer % Eeprom->PageSize;
+	Eeprom->PageBuf[Offset] = Data;
+	Eeprom->Latched[Offset] = TRUE;
+	Eeprom->LatchedCount++;
+	Eeprom->Pointer = (Eeprom->Pointer - Offset) +
+			  ((Offset + 1U) % Eeprom->PageSize);
+
+	return TRUE;
+}
+
+static u8 EepromSim_Read(IicSim_Device *Dev)
+{
+	EepromSim *Eeprom = Dev->Priv;
+	u8 Data;
+
+	Data = Eeprom->Mem[Eeprom->Pointer];
+	Eeprom->Pointer = (Eeprom->Pointer + 1U) % Eeprom->Size;
+
+	return Data;
+}
+
+static void EepromSim_Stop(IicSim_Device *Dev, u32 IsRepeatedStart)
+{
+	EepromSim *Eeprom = Dev->Priv;
+	u32 PageBase;
+	u32 Offset;
+
+	if ((Eeprom->State == EEPROM_SIM_DATA) && (IsRepeatedStart == FALSE) &&
+	    (Eeprom->LatchedCount != 0U)) {
+		PageBase = Eeprom->Pointer - (Eeprom->Pointer % Eeprom->PageSize);
+		for (Offset = 0U; Offset < Eeprom->PageSize; Offset++) {
+			if (Eeprom->Latched[Offset] != FALSE) {
+				Eeprom->Mem[PageBase + Offset] =
+					Eeprom->PageBuf[Offset];
+			}
+		}
+		Eeprom->BusyUntilUs = IicSim_NowUs() + Eeprom->WriteCycleUs;
+		Eeprom->BusyTimeUs += Eeprom->WriteCycleUs;
+		Eeprom->WriteCycles++;
+	}
+
+	Eeprom->State = EEPROM_SIM_IDLE;
+}
+
+static const IicSim_DeviceOps EepromSim_Ops = {
+	EepromSim_Start,
+	EepromSim_Write,
+	EepromSim_Read,
+	EepromSim_Stop,
+};
+
+/*****************************************************************************/
+/**
+* Looks up the profile of an EEPROM part.
+*
+* @param	Name is the part name, M24C02, M24C08, 24C64 or M24128.
+*
+* @return	The profile, or NULL if the part is not known.
+*
+* @note		None.
+*
+******************************************************************************/
+const EepromSim_Profile *EepromSim_FindProfile(const char *Name)
+{
+	u32 Index;
+
+	for (Index = 0U; Index < (sizeof(EepromSim_Profiles) /
+				  sizeof(EepromSim_Profiles[0])); Index++) {
+		if (strcmp(EepromSim_Profiles[Index].Name, Name) == 0) {
+			return &EepromSim_Profiles[Index];
+		}
+	}
+
+	return NULL;
+}
+
+/*****************************************************************************/
+/**
+* Creates an erased EEPROM.
+*
+* @param	Name is the name used in the reports.
+* @param	Addr is the 7-bit slave address with the block select bits
+*		of the part clear.
+* @param	Profile is the part, see EepromSim_FindProfile().
+* @param	WriteCycleUs is the internal write cycle time tWR, 0 for
+*		the one of the profile.
+*
+* @return	The device, ready to be attached to a bus.
+*
+* @note		The device answers 1 << Profile->BlockBits slave addresses
+*		starting at Addr.
+*
+******************************************************************************/
+IicSim_Device *EepromSim_Create(const char *Name, u16 Addr,
+				const EepromSim_Profile *Profile,
+				u32 WriteCycleUs)
+{
+	EepromSim *Eeprom = calloc(1, sizeof(*Eeprom));
+
+	Eeprom->Mem = malloc(Profile->Size);
+	memset(Eeprom->Mem, 0xFF, Profile->Size);
+	Eeprom->Size = Profile->Size;
+	Eeprom->PageSize = Profile->PageSize;
+	Eeprom->AddrBytes = Profile->AddrBytes;
+	Eeprom->WriteCycleUs = (WriteCycleUs != 0U) ? WriteCycleUs :
+			       Profile->WriteCycleUs;
+
+	Eeprom->Dev.Name = Name;
+	Eeprom->Dev.Addr = Addr;
+	Eeprom->Dev.AddrMask = (u16)((1U << Profile->BlockBits) - 1U);
+	Eeprom->Dev.Ops = &EepromSim_Ops;
+	Eeprom->Dev.Priv = Eeprom;
+
+	return &Eeprom->Dev;
+}
+
+/*****************************************************************************/
+/**
+* Prints the write cycle statistics of an EEPROM.
+*
+******************************************************************************/
+void EepromSim_Report(IicSim_Device *Dev)
+{
+	EepromSim *Eeprom = Dev->Priv;
+
+	xil_printf("sim: %s @0x%02X: %u write cycles, %u us in tWR, "
+		   "%u NACKs while busy\r\n", Dev->Name, Dev->Addr,
+		   Eeprom->WriteCycles, (u32)Eeprom->BusyTimeUs,
+		   Eeprom->BusyNacks);
+}
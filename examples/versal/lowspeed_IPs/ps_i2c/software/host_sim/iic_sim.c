@@ -0,0 +1,297 @@
+/******************************************************************************
+* Copyright (C) 2021 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file iic_sim.c
+*
+* Bus level model of the simulated IIC controllers. It resolves which device
+* answers an address through the mux tree and sequences the START, data and
+* STOP conditions of a master transfer.
+*
+* Each condition takes its time on the bus at the SCL rate set for the
+* controller: a START, repeated START or STOP one bit time, the address byte
+* and every data byte nine bit times with the acknowledge. The time is spent
+* before the device sees the condition, so that a write cycle started by a
+* STOP begins after the last byte has been clocked out.
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include "xil_printf.h"
+#include "iic_sim.h"
+
+/************************** Constant Definitions *****************************/
+
+#define IIC_SIM_BITS_CONDITION	1U	/* START, repeated START or STOP */
+#define IIC_SIM_BITS_BYTE	9U	/* Eight data bits and the acknowledge */
+
+/**************************** Type Definitions *******************************/
+
+typedef struct {
+	IicSim_Device *Devices;	/* All devices on the bus */
+	IicSim_Device *Active;	/* Device addressed by the open transaction */
+	u32 Held;		/* Bus held after a transfer without STOP */
+	u32 SClkHz;		/* SCL rate, 0 until set */
+	u32 BitRemNs;		/* Fraction of a ns left over, in ns * Hz */
+
+	u32 Transfers;		/* Transfers and probes started */
+	u32 Nacks;		/* Transfers ended by a NACK */
+	u64 Bytes;		/* Data bytes acknowledged or read */
+	u64 BusyNs;		/* Time the bus was driven */
+} IicSim_Bus;
+
+/************************** Variable Definitions *****************************/
+
+static IicSim_Bus Buses[IIC_SIM_NUM_BUSES];
+
+/************************** Function Definitions *****************************/
+
+/*****************************************************************************/
+/**
+* Spends the time of a number of SCL periods on a bus.
+*
+******************************************************************************/
+static void IicSim_Clock(IicSim_Bus *BusPtr, u32 Bits)
+{
+	u64 SClkHz = (BusPtr->SClkHz != 0U) ? BusPtr->SClkHz : IIC_SIM_SCLK_HZ;
+	u64 Total = (u64)Bits * 1000000000U + BusPtr->BitRemNs;
+	u64 Ns = Total / SClkHz;
+
+	BusPtr->BitRemNs = (u32)(Total % SClkHz);
+	BusPtr->BusyNs += Ns;
+	IicSim_AdvanceNs(Ns);
+}
+
+/*****************************************************************************/
+/**
+* Attaches a device to a bus, either on the root segment or behind a mux.
+*
+* @param	Bus is the index of the controller the device is wired to.
+* @param	Dev is the device to attach.
+* @param	Parent is the upstream mux, or NULL for the root segment.
+* @param	Channel is the channel bit of the upstream mux.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+void IicSim_AttachDevice(u32 Bus, IicSim_Device *Dev, IicSim_Device *Parent,
+			 u8 Channel)
+{
+	IicSim_Device **Tail = &Buses[Bus].Devices;
+
+	Dev->Parent = Parent;
+	Dev->ParentChannel = Channel;
+	Dev->Next = NULL;
+
+	while (*Tail != NULL) {
+		Tail = &(*Tail)->Next;
+	}
+	*Tail = Dev;
+}
+
+/*****************************************************************************/
+/**
+* Checks whether a device is currently connected to the controller, that is
+* it is plugged in and every mux between the controller and the device has
+* the channel open.
+*
+******************************************************************************/
+static u32 IicSim_IsVisible(const IicSim_Device *Dev)
+{
+	if ((Dev->PlugPeriodUs != 0U) &&
+	    (((IicSim_NowUs() / Dev->PlugPeriodUs) % 2U) != 0U)) {
+		return FALSE;
+	}
+
+	while (Dev->Parent != NULL) {
+		if ((Dev->Parent->ChannelMask & Dev->ParentChannel) == 0U) {
+			return FALSE;
+		}
+		Dev = Dev->Parent;
+	}
+
+	return TRUE;
+}
+
+/*****************************************************************************/
+/**
+* Ends the part the active device plays in the open transaction.
+*
+******************************************************************************/
+static void IicSim_EndTransaction(IicSim_Bus *BusPtr, u32 IsRepeatedStart)
+{
+	if (IsRepeatedStart == FALSE) {
+		IicSim_Clock(BusPtr, IIC_SIM_BITS_CONDITION);
+	}
+	if (BusPtr->Active != NULL) {
+		BusPtr->Active->Ops->Stop(BusPtr->Active, IsRepeatedStart);
+		BusPtr->Active = NULL;
+	}
+	if (IsRepeatedStart == FALSE) {
+		BusPtr->Held = FALSE;
+	}
+}
+
+/*****************************************************************************/
+/**
+* Issues a START (or a repeated START when the bus is held) followed by the
+* address byte, and records which device acknowledged it.
+*
+******************************************************************************/
+static s32 IicSim_Address(IicSim_Bus *BusPtr, u16 SlaveAddr, u32 IsRead)
+{
+	IicSim_Device *Dev;
+
+	if (BusPtr->Held != FALSE) {
+		IicSim_EndTransaction(BusPtr, TRUE);
+	}
+	BusPtr->Transfers++;
+	IicSim_Clock(BusPtr, IIC_SIM_BITS_CONDITION + IIC_SIM_BITS_BYTE);
+
+	for (Dev = BusPtr->Devices; Dev != NULL; Dev = Dev->Next) {
+		if (((SlaveAddr & ~Dev->AddrMask) != Dev->Addr) ||
+		    (IicSim_IsVisible(Dev) == FALSE)) {
+			continue;
+		}
+		if (Dev->Ops->Start(Dev, SlaveAddr, IsRead) != FALSE) {
+			BusPtr->Active = Dev;
+			return IIC_SIM_ACK;
+		}
+	}
+
+	return IIC_SIM_NACK_ADDR;
+}
+
+/*****************************************************************************/
+/**
+* Performs a master transfer on a simulated bus.
+*
+* @param	Bus is the index of the controller.
+* @param	SlaveAddr is the 7-bit address of the slave.
+* @param	IsRead is TRUE for a master receive.
+* @param	Buffer holds the data to send or receives the data read.
+* @param	ByteCount is the number of data bytes.
+* @param	Hold keeps the bus after the transfer so that the next one
+*		starts with a repeated START instead of a STOP and START.
+*
+* @return	IIC_SIM_ACK, or IIC_SIM_NACK_ADDR / IIC_SIM_NACK_DATA when the
+*		slave did not acknowledge. A STOP is always issued after a
+*		NACK.
+*
+* @note		None.
+*
+******************************************************************************/
+s32 IicSim_Transfer(u32 Bus, u16 SlaveAddr, u32 IsRead, u8 *Buffer,
+		    u32 ByteCount, u32 Hold)
+{
+	IicSim_Bus *BusPtr = &Buses[Bus];
+	s32 Status;
+	u32 Index;
+
+	Status = IicSim_Address(BusPtr, SlaveAddr, IsRead);
+	if (Status != IIC_SIM_ACK) {
+		BusPtr->Nacks++;
+		IicSim_EndTransaction(BusPtr, FALSE);
+		return Status;
+	}
+
+	for (Index = 0; Index < ByteCount; Index++) {
+		IicSim_Clock(BusPtr, IIC_SIM_BITS_BYTE);
+		if (IsRead != FALSE) {
+			Buffer[Index] = BusPtr->Active->Ops->Read(BusPtr->Active);
+		} else if (BusPtr->Active->Ops->Write(BusPtr->Active,
+						      Buffer[Index]) == FALSE) {
+			BusPtr->Nacks++;
+			IicSim_EndTransaction(BusPtr, FALSE);
+			return IIC_SIM_NACK_DATA;
+		}
+		BusPtr->Bytes++;
+	}
+
+	if (Hold != FALSE) {
+		BusPtr->Held = TRUE;
+	} else {
+		IicSim_EndTransaction(BusPtr, FALSE);
+	}
+
+	return IIC_SIM_ACK;
+}
+
+/*****************************************************************************/
+/**
+* Addresses a slave for writing and issues a STOP straight after the address
+* byte, which is what the slave monitor of the controller does.
+*
+* @param	Bus is the index of the controller.
+* @param	SlaveAddr is the 7-bit address of the slave.
+*
+* @return	IIC_SIM_ACK if the slave acknowledged, else IIC_SIM_NACK_ADDR.
+*
+* @note		None.
+*
+******************************************************************************/
+s32 IicSim_Probe(u32 Bus, u16 SlaveAddr)
+{
+	return IicSim_Transfer(Bus, SlaveAddr, FALSE, NULL, 0U, FALSE);
+}
+
+/*****************************************************************************/
+/**
+* Returns TRUE while a transfer left the bus held for a repeated START.
+*
+******************************************************************************/
+u32 IicSim_BusIsHeld(u32 Bus)
+{
+	return Buses[Bus].Held;
+}
+
+/*****************************************************************************/
+/**
+* Issues a STOP on a held bus.
+*
+******************************************************************************/
+void IicSim_ReleaseBus(u32 Bus)
+{
+	if (Buses[Bus].Held != FALSE) {
+		IicSim_EndTransaction(&Buses[Bus], FALSE);
+	}
+}
+
+/*****************************************************************************/
+/**
+* Sets the SCL rate the bus conditions and bytes are timed at.
+*
+* @param	Bus is the index of the controller.
+* @param	SClkHz is the SCL rate in Hz, 0 for IIC_SIM_SCLK_HZ.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+void IicSim_SetSClk(u32 Bus, u32 SClkHz)
+{
+	Buses[Bus].SClkHz = SClkHz;
+}
+
+/*****************************************************************************/
+/**
+* Prints the traffic statistics of a bus.
+*
+******************************************************************************/
+void IicSim_ReportBus(u32 Bus)
+{
+	IicSim_Bus *BusPtr = &Buses[Bus];
+
+	xil_printf("sim: I2C%u at %u Hz: %u transfers, %u NACKed, %u bytes, "
+		   "%u us bus busy\r\n", Bus,
+		   (BusPtr->SClkHz != 0U) ? BusPtr->SClkHz : IIC_SIM_SCLK_HZ,
+		   BusPtr->Transfers, BusPtr->Nacks, (u32)BusPtr->Bytes,
+		   (u32)(BusPtr->BusyNs / 1000U));
+}
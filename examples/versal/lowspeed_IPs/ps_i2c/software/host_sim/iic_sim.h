@@ -0,0 +1,127 @@
+/******************************************************************************
+* Copyright (C) 2021 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file iic_sim.h
+*
+* Interface of the host side IIC bus simulator used to run the PS IIC EEPROM
+* examples on Linux.
+*
+* Every PS IIC controller owns one simulated bus. Devices are attached either
+* to the root segment of a bus or behind a channel of a simulated mux, and
+* only take part in a transfer while every mux on their path has the
+* corresponding channel open.
+*
+* A device model implements the IicSim_DeviceOps callbacks, which are called
+* at the bus conditions the device would observe: START (or repeated START)
+* with its address, every byte written or read, and the end of its part of
+* the transaction, which is either a STOP or a repeated START.
+*
+* Every bus condition takes its time at the SCL rate of the controller: one
+* bit time for a START or STOP and nine for each byte with its acknowledge.
+*
+******************************************************************************/
+
+#ifndef IIC_SIM_H	/* prevent circular inclusions */
+#define IIC_SIM_H
+
+#include "xil_types.h"
+
+/************************** Constant Definitions *****************************/
+
+#define IIC_SIM_NUM_BUSES	2U	/**< One bus per PS IIC controller */
+
+#define IIC_SIM_ACK		0	/**< Transfer acknowledged */
+#define IIC_SIM_NACK_ADDR	1	/**< Address phase not acknowledged */
+#define IIC_SIM_NACK_DATA	2	/**< Data byte not acknowledged */
+
+#define IIC_SIM_SCLK_HZ		100000U	/**< SCL rate after reset */
+
+/**************************** Type Definitions *******************************/
+
+typedef struct IicSim_Device IicSim_Device;
+
+/**
+ * Callbacks implemented by a simulated device.
+ */
+typedef struct {
+	/** START or repeated START addressed to the device, returns TRUE to ACK */
+	u32 (*Start)(IicSim_Device *Dev, u16 SlaveAddr, u32 IsRead);
+	/** Byte written by the master, returns TRUE to ACK */
+	u32 (*Write)(IicSim_Device *Dev, u8 Data);
+	/** Byte requested by the master */
+	u8 (*Read)(IicSim_Device *Dev);
+	/** End of the transaction, IsRepeatedStart is FALSE for a STOP */
+	void (*Stop)(IicSim_Device *Dev, u32 IsRepeatedStart);
+} IicSim_DeviceOps;
+
+/**
+ * A device attached to a simulated bus.
+ */
+struct IicSim_Device {
+	const char *Name;		/**< Name used in the reports */
+	u16 Addr;			/**< 7-bit slave address */
+	u16 AddrMask;			/**< Address bits ignored when matching */
+	const IicSim_DeviceOps *Ops;	/**< Device behaviour */
+	void *Priv;			/**< Device model state */
+	u8 ChannelMask;			/**< Open channels if the device is a mux */
+	IicSim_Device *Parent;		/**< Upstream mux, NULL on root segment */
+	u8 ParentChannel;		/**< Channel bit on the upstream mux */
+	IicSim_Device *Next;		/**< Next device on the same bus */
+	u32 PlugPeriodUs;		/**< Plugged and unplugged in turn for
+					     this long, 0 if always plugged */
+};
+
+/**
+ * Geometry and timing of an EEPROM part, see EepromSim_FindProfile().
+ */
+typedef struct {
+	const char *Name;	/**< Part name */
+	u32 Size;		/**< Capacity in bytes */
+	u32 PageSize;		/**< Page buffer size in bytes */
+	u32 AddrBytes;		/**< Word address length, 1 or 2 */
+	u32 BlockBits;		/**< Slave address bits selecting a 256 or
+				     65536 byte block */
+	u32 WriteCycleUs;	/**< Internal write cycle time, tWR */
+} EepromSim_Profile;
+
+/************************** Function Prototypes ******************************/
+
+/* Bus */
+void IicSim_AttachDevice(u32 Bus, IicSim_Device *Dev, IicSim_Device *Parent,
+			 u8 Channel);
+s32 IicSim_Transfer(u32 Bus, u16 SlaveAddr, u32 IsRead, u8 *Buffer,
+		    u32 ByteCount, u32 Hold);
+s32 IicSim_Probe(u32 Bus, u16 SlaveAddr);
+u32 IicSim_BusIsHeld(u32 Bus);
+void IicSim_ReleaseBus(u32 Bus);
+void IicSim_SetSClk(u32 Bus, u32 SClkHz);
+void IicSim_ReportBus(u32 Bus);
+
+/* Clock */
+u64 IicSim_NowNs(void);
+u64 IicSim_NowUs(void);
+u64 IicSim_HostUs(void);
+void IicSim_AdvanceNs(u64 Ns);
+
+/* Interrupts */
+u32 IicSim_IrqIsRaised(u32 IntId);
+u32 IicSim_TimerIrqIsRaised(u32 IntId);
+void IicSim_CpuPoll(void);
+
+/* Topology */
+void IicSim_BuildTopology(void);
+void IicSim_Report(void);
+
+/* Device models */
+const EepromSim_Profile *EepromSim_FindProfile(const char *Name);
+IicSim_Device *EepromSim_Create(const char *Name, u16 Addr,
+				const EepromSim_Profile *Profile,
+				u32 WriteCycleUs);
+void EepromSim_Report(IicSim_Device *Dev);
+IicSim_Device *MuxSim_Create(const char *Name, u16 Addr);
+
+#endif /* IIC_SIM_H */
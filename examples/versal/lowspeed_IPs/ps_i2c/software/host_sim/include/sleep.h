@@ -0,0 +1,27 @@
+/******************************************************************************
+* Copyright (C) 2021 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file sleep.h
+*
+* Host simulation replacement for the standalone BSP delay functions. The
+* delays are routed through the simulator so that they share its notion of
+* time with the simulated devices.
+*
+******************************************************************************/
+
+#ifndef SLEEP_H		/* prevent circular inclusions */
+#define SLEEP_H
+
+#include "xil_types.h"
+
+int IicSim_Usleep(unsigned long useconds);
+unsigned IicSim_Sleep(unsigned int seconds);
+
+#define usleep(useconds)	IicSim_Usleep(useconds)
+#define sleep(seconds)		IicSim_Sleep(seconds)
+
+#endif /* SLEEP_H */
@@ -0,0 +1,110 @@
+/******************************************************************************
+* Copyright (C) 2021 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file xiicps.h
+*
+* Host simulation replacement for the XIicPs driver interface. The types,
+* option flags and event codes match the standalone driver so that the PS
+* IIC examples build unchanged; the transfers are carried out against the
+* simulated devices attached to each controller.
+*
+******************************************************************************/
+
+#ifndef XIICPS_H	/* prevent circular inclusions */
+#define XIICPS_H
+
+#include "xil_types.h"
+#include "xstatus.h"
+#include "xiicps_hw.h"
+
+/** @name Configuration options
+ * @{
+ */
+#define XIICPS_7_BIT_ADDR_OPTION	0x01U	/**< 7-bit address mode */
+#define XIICPS_10_BIT_ADDR_OPTION	0x02U	/**< 10-bit address mode */
+#define XIICPS_SLAVE_MON_OPTION		0x04U	/**< Slave monitor mode */
+#define XIICPS_REP_START_OPTION		0x08U	/**< Repeated Start */
+/* @} */
+
+/** @name Callback events
+ * @{
+ */
+#define XIICPS_EVENT_COMPLETE_SEND	0x0001U	/**< Transmit Complete Event*/
+#define XIICPS_EVENT_COMPLETE_RECV	0x0002U	/**< Receive Complete Event*/
+#define XIICPS_EVENT_TIME_OUT		0x0004U	/**< Transfer timed out */
+#define XIICPS_EVENT_ERROR		0x0008U	/**< Receive error */
+#define XIICPS_EVENT_ARB_LOST		0x0010U	/**< Arbitration lost */
+#define XIICPS_EVENT_NACK		0x0020U	/**< NACK Received */
+#define XIICPS_EVENT_SLAVE_RDY		0x0040U	/**< Slave ready */
+#define XIICPS_EVENT_RX_OVR		0x0080U	/**< RX overflow */
+#define XIICPS_EVENT_TX_OVR		0x0100U	/**< TX overflow */
+#define XIICPS_EVENT_RX_UNF		0x0200U	/**< RX underflow */
+/* @} */
+
+typedef void (*XIicPs_IntrHandler) (void *CallBackRef, u32 StatusEvent);
+
+/**
+ * This typedef contains configuration information for the device.
+ */
+typedef struct {
+	u16 DeviceId;		/**< Unique ID of device */
+	UINTPTR BaseAddress;	/**< Base address of the device */
+	u32 InputClockHz;	/**< Input clock frequency */
+} XIicPs_Config;
+
+/**
+ * The XIicPs driver instance data.
+ */
+typedef struct {
+	XIicPs_Config Config;	/**< Configuration structure */
+	u32 IsReady;		/**< Device is initialized and ready */
+	u32 Options;		/**< Options set in the device */
+
+	u8 *SendBufferPtr;	/**< Pointer to send buffer */
+	u8 *RecvBufferPtr;	/**< Pointer to recv buffer */
+	s32 SendByteCount;	/**< Number of bytes still expected to send */
+	s32 RecvByteCount;	/**< Number of bytes still expected to receive */
+	s32 CurrByteCount;	/**< No. of bytes expected in current transfer */
+
+	s32 UpdateTxSize;	/**< If tx size register has to be updated */
+	s32 IsSend;		/**< Whether master is sending or receiving */
+	s32 IsRepeatedStart;	/**< Indicates if user set repeated start */
+	s32 Is10BitAddr;	/**< Indicates if user set 10 bit address */
+
+	XIicPs_IntrHandler StatusHandler;  /**< Event handler function */
+	void *CallBackRef;	/**< Callback reference for event handler */
+} XIicPs;
+
+XIicPs_Config *XIicPs_LookupConfig(u16 DeviceId);
+s32 XIicPs_CfgInitialize(XIicPs *InstancePtr, XIicPs_Config *ConfigPtr,
+				  u32 EffectiveAddr);
+void XIicPs_Reset(XIicPs *InstancePtr);
+void XIicPs_Abort(XIicPs *InstancePtr);
+
+void XIicPs_MasterSend(XIicPs *InstancePtr, u8 *MsgPtr, s32 ByteCount,
+		 u16 SlaveAddr);
+void XIicPs_MasterRecv(XIicPs *InstancePtr, u8 *MsgPtr, s32 ByteCount,
+		 u16 SlaveAddr);
+s32 XIicPs_MasterSendPolled(XIicPs *InstancePtr, u8 *MsgPtr, s32 ByteCount,
+		 u16 SlaveAddr);
+s32 XIicPs_MasterRecvPolled(XIicPs *InstancePtr, u8 *MsgPtr, s32 ByteCount,
+		 u16 SlaveAddr);
+void XIicPs_EnableSlaveMonitor(XIicPs *InstancePtr, u16 SlaveAddr);
+void XIicPs_DisableSlaveMonitor(XIicPs *InstancePtr);
+s32 XIicPs_BusIsBusy(XIicPs *InstancePtr);
+
+void XIicPs_SetStatusHandler(XIicPs *InstancePtr, void *CallBackRef,
+			     XIicPs_IntrHandler FunctionPtr);
+void XIicPs_MasterInterruptHandler(XIicPs *InstancePtr);
+
+s32 XIicPs_SetOptions(XIicPs *InstancePtr, u32 Options);
+s32 XIicPs_ClearOptions(XIicPs *InstancePtr, u32 Options);
+u32 XIicPs_GetOptions(XIicPs *InstancePtr);
+s32 XIicPs_SetSClk(XIicPs *InstancePtr, u32 FsclHz);
+u32 XIicPs_GetSClk(XIicPs *InstancePtr);
+
+#endif /* XIICPS_H */
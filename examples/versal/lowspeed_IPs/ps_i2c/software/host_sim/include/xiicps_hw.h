@@ -0,0 +1,90 @@
+/******************************************************************************
+* Copyright (C) 2021 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file xiicps_hw.h
+*
+* Host simulation replacement for the PS IIC register definitions. Register
+* accesses are routed to the simulated controller instead of the hardware.
+*
+******************************************************************************/
+
+#ifndef XIICPS_HW_H	/* prevent circular inclusions */
+#define XIICPS_HW_H
+
+#include "xil_types.h"
+
+/** @name Register Map
+ * @{
+ */
+#define XIICPS_CR_OFFSET		0x00U	/**< Control Register */
+#define XIICPS_SR_OFFSET		0x04U	/**< Status Register */
+#define XIICPS_ADDR_OFFSET		0x08U	/**< IIC Address Register */
+#define XIICPS_DATA_OFFSET		0x0CU	/**< IIC Data Register */
+#define XIICPS_ISR_OFFSET		0x10U	/**< Interrupt Status Register */
+#define XIICPS_TRANS_SIZE_OFFSET	0x14U	/**< Transfer Size Register */
+#define XIICPS_SLV_PAUSE_OFFSET		0x18U	/**< Slave monitor pause Register */
+#define XIICPS_TIME_OUT_OFFSET		0x1CU	/**< Time Out Register */
+#define XIICPS_IMR_OFFSET		0x20U	/**< Interrupt Mask Register */
+#define XIICPS_IER_OFFSET		0x24U	/**< Interrupt Enable Register */
+#define XIICPS_IDR_OFFSET		0x28U	/**< Interrupt Disable Register */
+/* @} */
+
+/** @name Control Register
+ * @{
+ */
+#define XIICPS_CR_HOLD_MASK		0x00000010U	/**< Hold Bus bit */
+#define XIICPS_CR_SLVMON_MASK		0x00000020U	/**< Slave monitor mode */
+/* @} */
+
+/** @name Status Register
+ * @{
+ */
+#define XIICPS_SR_BA_MASK		0x00000100U	/**< Bus Active Mask */
+/* @} */
+
+/** @name Interrupt Registers
+ * @{
+ */
+#define XIICPS_IXR_ARB_LOST_MASK	0x00000200U	/**< Arbitration Lost */
+#define XIICPS_IXR_RX_UNF_MASK		0x00000080U	/**< FIFO Recieve Underflow */
+#define XIICPS_IXR_TX_OVR_MASK		0x00000040U	/**< Transmit Overflow */
+#define XIICPS_IXR_RX_OVR_MASK		0x00000020U	/**< Overflow */
+#define XIICPS_IXR_SLV_RDY_MASK		0x00000010U	/**< Monitored slave ready */
+#define XIICPS_IXR_TO_MASK		0x00000008U	/**< Transfer timed out */
+#define XIICPS_IXR_NACK_MASK		0x00000004U	/**< NACK received */
+#define XIICPS_IXR_DATA_MASK		0x00000002U	/**< IIC Data */
+#define XIICPS_IXR_COMP_MASK		0x00000001U	/**< Transfer Complete */
+#define XIICPS_IXR_DEFAULT_MASK		0x000002FFU	/**< Default ISR Mask */
+#define XIICPS_IXR_ALL_INTR_MASK	0x000002FFU	/**< All ISR Mask */
+/* @} */
+
+#define XIICPS_FIFO_DEPTH		16U	/**< Max FIFO depth */
+#define XIICPS_MAX_TRANSFER_SIZE	(u32)(255U - 3U) /**< Max transfer size */
+
+u32 IicSim_ReadReg(UINTPTR BaseAddress, u32 RegOffset);
+void IicSim_WriteReg(UINTPTR BaseAddress, u32 RegOffset, u32 RegisterValue);
+
+#define XIicPs_ReadReg(BaseAddress, RegOffset) \
+	IicSim_ReadReg((UINTPTR)(BaseAddress), (u32)(RegOffset))
+
+#define XIicPs_WriteReg(BaseAddress, RegOffset, RegisterValue) \
+	IicSim_WriteReg((UINTPTR)(BaseAddress), (u32)(RegOffset), \
+			(u32)(RegisterValue))
+
+#define XIicPs_EnableInterrupts(BaseAddress, IntrMask) \
+	XIicPs_WriteReg((BaseAddress), XIICPS_IER_OFFSET, (IntrMask))
+
+#define XIicPs_DisableInterrupts(BaseAddress, IntrMask) \
+	XIicPs_WriteReg((BaseAddress), XIICPS_IDR_OFFSET, (IntrMask))
+
+#define XIicPs_EnableAllInterrupts(BaseAddress) \
+	XIicPs_EnableInterrupts((BaseAddress), XIICPS_IXR_DEFAULT_MASK)
+
+#define XIicPs_DisableAllInterrupts(BaseAddress) \
+	XIicPs_DisableInterrupts((BaseAddress), XIICPS_IXR_ALL_INTR_MASK)
+
+#endif /* XIICPS_HW_H */
@@ -0,0 +1,33 @@
+/******************************************************************************
+* Copyright (C) 2021 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file xil_exception.h
+*
+* Host simulation replacement for the standalone BSP exception handling. Only
+* the IRQ exception is modelled: the registered handler is called for a
+* raised interrupt while the exception is enabled.
+*
+******************************************************************************/
+
+#ifndef XIL_EXCEPTION_H	/* prevent circular inclusions */
+#define XIL_EXCEPTION_H
+
+#include "xil_types.h"
+
+#define XIL_EXCEPTION_ID_IRQ_INT	5U	/**< IRQ exception */
+
+typedef void (*Xil_ExceptionHandler)(void *data);
+typedef void (*Xil_InterruptHandler)(void *data);
+
+void Xil_ExceptionInit(void);
+void Xil_ExceptionRegisterHandler(u32 Exception_id,
+				  Xil_ExceptionHandler Handler, void *Data);
+void Xil_ExceptionRemoveHandler(u32 Exception_id);
+void Xil_ExceptionEnable(void);
+void Xil_ExceptionDisable(void);
+
+#endif /* XIL_EXCEPTION_H */
@@ -0,0 +1,21 @@
+/******************************************************************************
+* Copyright (C) 2021 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file xil_printf.h
+*
+* Host simulation replacement for the standalone BSP console output.
+*
+******************************************************************************/
+
+#ifndef XIL_PRINTF_H	/* prevent circular inclusions */
+#define XIL_PRINTF_H
+
+#include "xil_types.h"
+
+void xil_printf(const char *ctrl1, ...);
+
+#endif /* XIL_PRINTF_H */
@@ -0,0 +1,41 @@
+/******************************************************************************
+* Copyright (C) 2021 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file xparameters.h
+*
+* Host simulation replacement for the generated xparameters.h. The values
+* describe the two PS IIC controllers of a Versal device, the interrupt
+* controller of the APU and TTC0.
+*
+******************************************************************************/
+
+#ifndef XPARAMETERS_H	/* prevent circular inclusions */
+#define XPARAMETERS_H
+
+#define XPAR_XIICPS_NUM_INSTANCES	2U
+
+#define XPAR_XIICPS_0_DEVICE_ID		0U
+#define XPAR_XIICPS_0_BASEADDR		0xFF020000U
+#define XPAR_XIICPS_0_I2C_CLK_FREQ_HZ	99999001U
+#define XPAR_XIICPS_0_INTR		46U
+
+#define XPAR_XIICPS_1_DEVICE_ID		1U
+#define XPAR_XIICPS_1_BASEADDR		0xFF030000U
+#define XPAR_XIICPS_1_I2C_CLK_FREQ_HZ	99999001U
+#define XPAR_XIICPS_1_INTR		47U
+
+#define XPAR_SCUGIC_SINGLE_DEVICE_ID	0U
+#define XPAR_SCUGIC_0_DEVICE_ID		0U
+#define XPAR_SCUGIC_0_CPU_BASEADDR	0xF9040000U
+#define XPAR_SCUGIC_0_DIST_BASEADDR	0xF9000000U
+
+#define XPAR_XTTCPS_0_DEVICE_ID		0U
+#define XPAR_XTTCPS_0_BASEADDR		0xFF0E0000U
+#define XPAR_XTTCPS_0_TTC_CLK_FREQ_HZ	100000000U
+#define XPAR_XTTCPS_0_INTR		69U
+
+#endif /* XPARAMETERS_H */
@@ -0,0 +1,23 @@
+/******************************************************************************
+* Copyright (C) 2021 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file xplatform_info.h
+*
+* Host simulation replacement for the standalone BSP platform query.
+*
+******************************************************************************/
+
+#ifndef XPLATFORM_INFO_H	/* prevent circular inclusions */
+#define XPLATFORM_INFO_H
+
+#include "xil_types.h"
+
+#define XPLAT_VERSAL		0x5U
+
+u32 XGetPlatform_Info(void);
+
+#endif /* XPLATFORM_INFO_H */
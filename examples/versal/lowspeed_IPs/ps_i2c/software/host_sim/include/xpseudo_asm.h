@@ -0,0 +1,23 @@
+/******************************************************************************
+* Copyright (C) 2021 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file xpseudo_asm.h
+*
+* Host simulation replacement for the processor instructions the examples
+* use. WFI returns once an enabled interrupt is raised, even with the IRQ
+* exception masked, as on the processor.
+*
+******************************************************************************/
+
+#ifndef XPSEUDO_ASM_H	/* prevent circular inclusions */
+#define XPSEUDO_ASM_H
+
+void IicSim_WaitForInterrupt(void);
+
+#define wfi()		IicSim_WaitForInterrupt()
+
+#endif /* XPSEUDO_ASM_H */
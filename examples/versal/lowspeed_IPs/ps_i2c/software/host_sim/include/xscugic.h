@@ -0,0 +1,63 @@
+/******************************************************************************
+* Copyright (C) 2021 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file xscugic.h
+*
+* Host simulation replacement for the XScuGic driver interface. The
+* interrupt controller keeps the handler table and the enable state of each
+* interrupt ID; the simulated processor takes the interrupts of the enabled
+* IDs whose simulated device raises its line.
+*
+******************************************************************************/
+
+#ifndef XSCUGIC_H	/* prevent circular inclusions */
+#define XSCUGIC_H
+
+#include "xil_types.h"
+#include "xstatus.h"
+#include "xil_exception.h"
+
+#define XSCUGIC_MAX_NUM_INTR_INPUTS	256U	/**< Interrupt IDs handled */
+
+/**
+ * The handler of an interrupt ID and its callback reference.
+ */
+typedef struct {
+	Xil_InterruptHandler Handler;	/**< Handler of the interrupt */
+	void *CallBackRef;		/**< Argument passed to the handler */
+} XScuGic_VectorTableEntry;
+
+/**
+ * This typedef contains configuration information for the device.
+ */
+typedef struct {
+	u16 DeviceId;		/**< Unique ID of device */
+	u32 CpuBaseAddress;	/**< CPU interface register base address */
+	u32 DistBaseAddress;	/**< Distributor register base address */
+	XScuGic_VectorTableEntry HandlerTable[XSCUGIC_MAX_NUM_INTR_INPUTS];
+} XScuGic_Config;
+
+/**
+ * The XScuGic driver instance data.
+ */
+typedef struct {
+	XScuGic_Config *Config;	/**< Configuration table entry */
+	u32 IsReady;		/**< Device is initialized and ready */
+	u32 UnhandledInterrupts; /**< Interrupts taken without a handler */
+} XScuGic;
+
+XScuGic_Config *XScuGic_LookupConfig(u16 DeviceId);
+s32 XScuGic_CfgInitialize(XScuGic *InstancePtr, XScuGic_Config *ConfigPtr,
+			  u32 EffectiveAddr);
+s32 XScuGic_Connect(XScuGic *InstancePtr, u32 Int_Id,
+		    Xil_InterruptHandler Handler, void *CallBackRef);
+void XScuGic_Disconnect(XScuGic *InstancePtr, u32 Int_Id);
+void XScuGic_Enable(XScuGic *InstancePtr, u32 Int_Id);
+void XScuGic_Disable(XScuGic *InstancePtr, u32 Int_Id);
+void XScuGic_InterruptHandler(XScuGic *InstancePtr);
+
+#endif /* XSCUGIC_H */
@@ -0,0 +1,27 @@
+/******************************************************************************
+* Copyright (C) 2021 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file xstatus.h
+*
+* Host simulation replacement for the standalone BSP status codes. Only the
+* codes used by the PS IIC examples are provided.
+*
+******************************************************************************/
+
+#ifndef XSTATUS_H	/* prevent circular inclusions */
+#define XSTATUS_H
+
+#include "xil_types.h"
+
+#define XST_SUCCESS			0L
+#define XST_FAILURE			1L
+#define XST_DEVICE_NOT_FOUND		2L
+#define XST_DEVICE_BUSY			21L
+#define XST_INVALID_PARAM		15L
+#define XST_IIC_BUS_BUSY		1144L
+
+#endif /* XSTATUS_H */
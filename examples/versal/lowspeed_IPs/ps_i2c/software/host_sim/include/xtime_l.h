@@ -0,0 +1,27 @@
+/******************************************************************************
+* Copyright (C) 2021 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file xtime_l.h
+*
+* Host simulation replacement for the standalone BSP global timer. The
+* counter runs at the rate of the Versal APU timestamp clock and follows the
+* simulator clock.
+*
+******************************************************************************/
+
+#ifndef XTIME_H		/* prevent circular inclusions */
+#define XTIME_H
+
+#include "xil_types.h"
+
+typedef u64 XTime;
+
+#define COUNTS_PER_SECOND	100000000U
+
+void XTime_GetTime(XTime *Xtime_Global);
+
+#endif /* XTIME_H */
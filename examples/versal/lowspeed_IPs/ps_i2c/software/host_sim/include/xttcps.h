@@ -0,0 +1,81 @@
+/******************************************************************************
+* Copyright (C) 2021 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file xttcps.h
+*
+* Host simulation replacement for the XTtcPs driver interface. Counter 0 of
+* TTC0 is simulated in interval mode, the mode the interrupt example uses to
+* end a WFI at the deadline of a wait. The counter runs on the simulated
+* clock and raises its interrupt each time it reaches the interval.
+*
+******************************************************************************/
+
+#ifndef XTTCPS_H	/* prevent circular inclusions */
+#define XTTCPS_H
+
+#include "xil_types.h"
+#include "xstatus.h"
+
+/** @name Configuration options
+ * @{
+ */
+#define XTTCPS_OPTION_EXTERNAL_CLK	0x00000001U	/**< External clock */
+#define XTTCPS_OPTION_INTERVAL_MODE	0x00000002U	/**< Interval mode */
+#define XTTCPS_OPTION_DECREMENT		0x00000004U	/**< Count down */
+#define XTTCPS_OPTION_MATCH_MODE	0x00000008U	/**< Match mode */
+#define XTTCPS_OPTION_WAVE_DISABLE	0x00000010U	/**< No waveform output */
+/* @} */
+
+/** @name Interrupt bits
+ * @{
+ */
+#define XTTCPS_IXR_INTERVAL_MASK	0x00000001U	/**< Interval reached */
+#define XTTCPS_IXR_MATCH_0_MASK		0x00000002U	/**< Match 0 */
+#define XTTCPS_IXR_MATCH_1_MASK		0x00000004U	/**< Match 1 */
+#define XTTCPS_IXR_MATCH_2_MASK		0x00000008U	/**< Match 2 */
+#define XTTCPS_IXR_CNT_OVR_MASK		0x00000010U	/**< Counter overflow */
+#define XTTCPS_IXR_ALL_MASK		0x0000001FU
+/* @} */
+
+#define XTTCPS_MAX_INTERVAL_COUNT	0xFFFFFFFFU
+
+#define XTTCPS_CLK_CNTRL_PS_DISABLE	16U	/**< Prescale disable value */
+
+typedef u32 XInterval;
+
+/**
+ * This typedef contains configuration information for the device.
+ */
+typedef struct {
+	u16 DeviceId;		/**< Unique ID of device */
+	u32 BaseAddress;	/**< Base address of the counter */
+	u32 InputClockHz;	/**< Input clock frequency */
+} XTtcPs_Config;
+
+/**
+ * The XTtcPs driver instance data.
+ */
+typedef struct {
+	XTtcPs_Config Config;	/**< Configuration structure */
+	u32 IsReady;		/**< Device is initialized and ready */
+} XTtcPs;
+
+XTtcPs_Config *XTtcPs_LookupConfig(u16 DeviceId);
+s32 XTtcPs_CfgInitialize(XTtcPs *InstancePtr, XTtcPs_Config *ConfigPtr,
+			 u32 EffectiveAddr);
+s32 XTtcPs_SetOptions(XTtcPs *InstancePtr, u32 Options);
+void XTtcPs_SetPrescaler(XTtcPs *InstancePtr, u8 PrescalerValue);
+void XTtcPs_SetInterval(XTtcPs *InstancePtr, XInterval Value);
+void XTtcPs_ResetCounterValue(XTtcPs *InstancePtr);
+void XTtcPs_Start(XTtcPs *InstancePtr);
+void XTtcPs_Stop(XTtcPs *InstancePtr);
+void XTtcPs_EnableInterrupts(XTtcPs *InstancePtr, u32 InterruptMask);
+void XTtcPs_DisableInterrupts(XTtcPs *InstancePtr, u32 InterruptMask);
+u32 XTtcPs_GetInterruptStatus(XTtcPs *InstancePtr);
+void XTtcPs_ClearInterruptStatus(XTtcPs *InstancePtr, u32 InterruptMask);
+
+#endif /* XTTCPS_H */
@@ -0,0 +1,261 @@
+/******************************************************************************
+* Copyright (C) 2021 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file intc_sim.c
+*
+* Host implementation of the XScuGic driver interface, the IRQ exception and
+* WFI. The simulated processor has no instruction boundaries to take an
+* interrupt at, so it takes the raised interrupts at the points where the
+* examples give it the chance: enabling the IRQ exception, reading a timer or
+* a controller register and sleeping. IicSim_CpuPoll() is called from those.
+*
+* An interrupt is taken when the IRQ exception is enabled, a handler is
+* registered for it, the interrupt ID is enabled in the interrupt controller
+* and the simulated controller raises it. The exception is masked while the
+* handler runs, as on the processor.
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <string.h>
+#include "xparameters.h"
+#include "xscugic.h"
+#include "xil_exception.h"
+#include "xpseudo_asm.h"
+#include "iic_sim.h"
+
+/************************** Constant Definitions *****************************/
+
+/*
+ * Longest WFI without an interrupt. The processor would also be woken by
+ * other interrupts, so the examples have to cope with an early return.
+ */
+#define SIM_WFI_MAX_US		1000U
+#define SIM_WFI_STEP_US		10U
+
+/*
+ * Interrupts taken in a row before the processor gets back to the program,
+ * in case a handler does not clear the interrupt it is called for.
+ */
+#define SIM_IRQ_MAX_NESTED	16U
+
+/************************** Variable Definitions *****************************/
+
+static XScuGic_Config XScuGic_ConfigTable[] = {
+	{
+		XPAR_SCUGIC_0_DEVICE_ID,
+		XPAR_SCUGIC_0_CPU_BASEADDR,
+		XPAR_SCUGIC_0_DIST_BASEADDR,
+		{{NULL, NULL}}
+	}
+};
+
+static u8 IntrEnabled[XSCUGIC_MAX_NUM_INTR_INPUTS];
+
+static Xil_ExceptionHandler IrqHandler;	/* Registered IRQ handler */
+static void *IrqData;			/* Argument of IrqHandler */
+static u32 IrqEnabled;			/* IRQ exception unmasked */
+static u32 InIrq;			/* Handler is running */
+
+/************************** Function Definitions *****************************/
+
+/*****************************************************************************/
+/**
+* Returns the highest priority interrupt ID that is enabled and raised, which
+* is the lowest ID in the simulation.
+*
+* @param	None.
+*
+* @return	The interrupt ID, or XSCUGIC_MAX_NUM_INTR_INPUTS if none.
+*
+* @note		None.
+*
+******************************************************************************/
+static u32 IicSim_PendingIntr(void)
+{
+	u32 IntId;
+
+	for (IntId = 0U; IntId < XSCUGIC_MAX_NUM_INTR_INPUTS; IntId++) {
+		if ((IntrEnabled[IntId] != FALSE) &&
+		    ((IicSim_IrqIsRaised(IntId) != FALSE) ||
+		     (IicSim_TimerIrqIsRaised(IntId) != FALSE))) {
+			return IntId;
+		}
+	}
+
+	return XSCUGIC_MAX_NUM_INTR_INPUTS;
+}
+
+/*****************************************************************************/
+/**
+* Takes the raised interrupts if the IRQ exception is enabled.
+*
+* @param	None.
+*
+* @return	None.
+*
+* @note		Nothing is taken while a handler runs.
+*
+******************************************************************************/
+void IicSim_CpuPoll(void)
+{
+	u32 Count;
+
+	if ((IrqEnabled == FALSE) || (InIrq != FALSE) || (IrqHandler == NULL)) {
+		return;
+	}
+
+	for (Count = 0U; (Count < SIM_IRQ_MAX_NESTED) &&
+	     (IicSim_PendingIntr() != XSCUGIC_MAX_NUM_INTR_INPUTS); Count++) {
+		InIrq = TRUE;
+		IrqHandler(IrqData);
+		InIrq = FALSE;
+	}
+}
+
+/*****************************************************************************/
+/**
+* Waits for an enabled interrupt to be raised, for SIM_WFI_MAX_US at most.
+* The interrupt is not taken here, it is taken once the IRQ exception is
+* enabled.
+*
+******************************************************************************/
+void IicSim_WaitForInterrupt(void)
+{
+	u64 EndUs = IicSim_NowUs() + SIM_WFI_MAX_US;
+
+	while ((IicSim_PendingIntr() == XSCUGIC_MAX_NUM_INTR_INPUTS) &&
+	       (IicSim_NowUs() < EndUs)) {
+		IicSim_AdvanceNs(SIM_WFI_STEP_US * 1000U);
+	}
+
+	IicSim_CpuPoll();
+}
+
+XScuGic_Config *XScuGic_LookupConfig(u16 DeviceId)
+{
+	u32 Index;
+
+	for (Index = 0U; Index < (sizeof(XScuGic_ConfigTable) /
+				  sizeof(XScuGic_ConfigTable[0])); Index++) {
+		if (XScuGic_ConfigTable[Index].DeviceId == DeviceId) {
+			return &XScuGic_ConfigTable[Index];
+		}
+	}
+
+	return NULL;
+}
+
+s32 XScuGic_CfgInitialize(XScuGic *InstancePtr, XScuGic_Config *ConfigPtr,
+			  u32 EffectiveAddr)
+{
+	(void)EffectiveAddr;
+
+	InstancePtr->Config = ConfigPtr;
+	InstancePtr->UnhandledInterrupts = 0U;
+	InstancePtr->IsReady = XIL_COMPONENT_IS_READY;
+	memset(IntrEnabled, 0, sizeof(IntrEnabled));
+
+	return XST_SUCCESS;
+}
+
+s32 XScuGic_Connect(XScuGic *InstancePtr, u32 Int_Id,
+		    Xil_InterruptHandler Handler, void *CallBackRef)
+{
+	if ((Int_Id >= XSCUGIC_MAX_NUM_INTR_INPUTS) || (Handler == NULL)) {
+		return XST_INVALID_PARAM;
+	}
+
+	InstancePtr->Config->HandlerTable[Int_Id].Handler = Handler;
+	InstancePtr->Config->HandlerTable[Int_Id].CallBackRef = CallBackRef;
+
+	return XST_SUCCESS;
+}
+
+void XScuGic_Disconnect(XScuGic *InstancePtr, u32 Int_Id)
+{
+	if (Int_Id < XSCUGIC_MAX_NUM_INTR_INPUTS) {
+		IntrEnabled[Int_Id] = FALSE;
+		InstancePtr->Config->HandlerTable[Int_Id].Handler = NULL;
+		InstancePtr->Config->HandlerTable[Int_Id].CallBackRef = NULL;
+	}
+}
+
+void XScuGic_Enable(XScuGic *InstancePtr, u32 Int_Id)
+{
+	(void)InstancePtr;
+
+	if (Int_Id < XSCUGIC_MAX_NUM_INTR_INPUTS) {
+		IntrEnabled[Int_Id] = TRUE;
+	}
+}
+
+void XScuGic_Disable(XScuGic *InstancePtr, u32 Int_Id)
+{
+	(void)InstancePtr;
+
+	if (Int_Id < XSCUGIC_MAX_NUM_INTR_INPUTS) {
+		IntrEnabled[Int_Id] = FALSE;
+	}
+}
+
+/*****************************************************************************/
+/**
+* IRQ handler of the interrupt controller. Calls the handler connected to the
+* highest priority raised interrupt.
+*
+******************************************************************************/
+void XScuGic_InterruptHandler(XScuGic *InstancePtr)
+{
+	XScuGic_VectorTableEntry *Entry;
+	u32 IntId = IicSim_PendingIntr();
+
+	if (IntId == XSCUGIC_MAX_NUM_INTR_INPUTS) {
+		return;
+	}
+
+	Entry = &InstancePtr->Config->HandlerTable[IntId];
+	if (Entry->Handler == NULL) {
+		InstancePtr->UnhandledInterrupts++;
+		IntrEnabled[IntId] = FALSE;
+		return;
+	}
+	Entry->Handler(Entry->CallBackRef);
+}
+
+void Xil_ExceptionInit(void)
+{
+}
+
+void Xil_ExceptionRegisterHandler(u32 Exception_id,
+				  Xil_ExceptionHandler Handler, void *Data)
+{
+	if (Exception_id == XIL_EXCEPTION_ID_IRQ_INT) {
+		IrqHandler = Handler;
+		IrqData = Data;
+	}
+}
+
+void Xil_ExceptionRemoveHandler(u32 Exception_id)
+{
+	if (Exception_id == XIL_EXCEPTION_ID_IRQ_INT) {
+		IrqHandler = NULL;
+		IrqData = NULL;
+	}
+}
+
+void Xil_ExceptionEnable(void)
+{
+	IrqEnabled = TRUE;
+	IicSim_CpuPoll();
+}
+
+void Xil_ExceptionDisable(void)
+{
+	IrqEnabled = FALSE;
+}
@@ -0,0 +1,77 @@
+/******************************************************************************
+* Copyright (C) 2021 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file mux_sim.c
+*
+* Model of a PCA9548/TCA9548 style IIC mux. The byte written to the device
+* is the mask of open downstream channels, reading returns it.
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <stdlib.h>
+#include "iic_sim.h"
+
+/************************** Function Definitions *****************************/
+
+static u32 MuxSim_Start(IicSim_Device *Dev, u16 SlaveAddr, u32 IsRead)
+{
+	(void)Dev;
+	(void)SlaveAddr;
+	(void)IsRead;
+
+	return TRUE;
+}
+
+static u32 MuxSim_Write(IicSim_Device *Dev, u8 Data)
+{
+	Dev->ChannelMask = Data;
+
+	return TRUE;
+}
+
+static u8 MuxSim_Read(IicSim_Device *Dev)
+{
+	return Dev->ChannelMask;
+}
+
+static void MuxSim_Stop(IicSim_Device *Dev, u32 IsRepeatedStart)
+{
+	(void)Dev;
+	(void)IsRepeatedStart;
+}
+
+static const IicSim_DeviceOps MuxSim_Ops = {
+	MuxSim_Start,
+	MuxSim_Write,
+	MuxSim_Read,
+	MuxSim_Stop,
+};
+
+/*****************************************************************************/
+/**
+* Creates a mux with all channels closed.
+*
+* @param	Name is the name used in the reports.
+* @param	Addr is the 7-bit slave address.
+*
+* @return	The device, ready to be attached to a bus.
+*
+* @note		None.
+*
+******************************************************************************/
+IicSim_Device *MuxSim_Create(const char *Name, u16 Addr)
+{
+	IicSim_Device *Dev = calloc(1, sizeof(*Dev));
+
+	Dev->Name = Name;
+	Dev->Addr = Addr;
+	Dev->Ops = &MuxSim_Ops;
+
+	return Dev;
+}
@@ -0,0 +1,114 @@
+/******************************************************************************
+* Copyright (C) 2021 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file platform_sim.c
+*
+* Host implementation of the standalone BSP services used by the examples:
+* console output, delays, the global timer and the platform query. Delays
+* and timer reads spend simulated time, see clock_sim.c, and give the
+* simulated processor the chance to take raised interrupts, see intc_sim.c.
+* It also
+* keeps the EEPROM topology of the examples in the file named by the
+* IICPS_SIM_TOPOLOGY_FILE environment variable, so that a second run finds
+* the EEPROM from the saved topology.
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "sleep.h"
+#include "xil_printf.h"
+#include "xplatform_info.h"
+#include "xtime_l.h"
+#include "iic_sim.h"
+
+/************************** Constant Definitions *****************************/
+
+/*
+ * Time a read of the global timer takes, so that a program waiting for a
+ * time to pass without doing anything else gets there on the virtual clock.
+ */
+#define SIM_TIMER_READ_NS	50U
+
+/************************** Function Definitions *****************************/
+
+void xil_printf(const char *ctrl1, ...)
+{
+	va_list Args;
+
+	va_start(Args, ctrl1);
+	vprintf(ctrl1, Args);
+	va_end(Args);
+	fflush(stdout);
+}
+
+int IicSim_Usleep(unsigned long useconds)
+{
+	IicSim_AdvanceNs((u64)useconds * 1000U);
+	IicSim_CpuPoll();
+
+	return 0;
+}
+
+unsigned IicSim_Sleep(unsigned int seconds)
+{
+	IicSim_Usleep((unsigned long)seconds * 1000000U);
+
+	return 0U;
+}
+
+void XTime_GetTime(XTime *Xtime_Global)
+{
+	IicSim_AdvanceNs(SIM_TIMER_READ_NS);
+	IicSim_CpuPoll();
+	*Xtime_Global = IicSim_NowNs() / (1000000000U / COUNTS_PER_SECOND);
+}
+
+u32 XGetPlatform_Info(void)
+{
+	return XPLAT_VERSAL;
+}
+
+u32 EepromTopologyLoad(void *BufferPtr, u32 ByteCount)
+{
+	const char *Path = getenv("IICPS_SIM_TOPOLOGY_FILE");
+	FILE *File;
+	size_t Count;
+
+	if (Path == NULL) {
+		return 0U;
+	}
+
+	File = fopen(Path, "rb");
+	if (File == NULL) {
+		return 0U;
+	}
+	Count = fread(BufferPtr, 1U, ByteCount, File);
+	fclose(File);
+
+	return (u32)Count;
+}
+
+void EepromTopologySave(const void *BufferPtr, u32 ByteCount)
+{
+	const char *Path = getenv("IICPS_SIM_TOPOLOGY_FILE");
+	FILE *File;
+
+	if (Path == NULL) {
+		return;
+	}
+
+	File = fopen(Path, "wb");
+	if (File == NULL) {
+		return;
+	}
+	fwrite(BufferPtr, 1U, ByteCount, File);
+	fclose(File);
+}
@@ -0,0 +1,188 @@
+/******************************************************************************
+* Copyright (C) 2021 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file topology_sim.c
+*
+* Board level wiring of the simulated devices. Each of the two PS IIC
+* controllers has a TCA9548 mux at 0x74 with two M24128 EEPROMs (16 KB, 64
+* byte pages, 2 byte word address) at 0x54 and 0x55 behind its first
+* channel, so that both the pipelined writes to several EEPROMs and the
+* concurrent use of the controllers have partners.
+*
+* The IICPS_SIM_EEPROM environment variable fits another part instead, see
+* EepromSim_FindProfile(). A part with block select bits takes the slave
+* addresses of the second EEPROM as well, which is then left out.
+*
+* With the IICPS_SIM_BOARD environment variable set to "sparse" the mux of
+* the first controller has nothing behind it and the EEPROMs of the second
+* controller are behind its second channel, so that the EEPROM search has
+* to run into the timeouts of absent devices on one bus while it finds the
+* EEPROM on the other.
+*
+* With IICPS_SIM_BOARD set to "cascade" the EEPROMs of the first controller
+* are behind a second TCA9548 at 0x75, one on each of its first two
+* channels, and that mux is behind the second channel of the mux at 0x74.
+* The examples have to be built with IIC_MUX_CASCADE to find them.
+*
+* With IICPS_SIM_HOTPLUG_US set, the EEPROM at 0x55 on the second controller
+* sits in a hot-plug slot behind the third channel of its mux and is
+* unplugged and plugged in again every that many us, for the hot-plug
+* monitor to notice. Being on a channel of its own, it is not written by the
+* examples that use every EEPROM next to the one under test.
+*
+* The write cycle time of the part can be changed with the
+* IICPS_SIM_TWR_US environment variable.
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "xil_printf.h"
+#include "iic_sim.h"
+
+/************************** Constant Definitions *****************************/
+
+#define SIM_EEPROM_PART	"M24128"
+#define SIM_EEPROMS_PER_BUS	2U
+#define SIM_EEPROM_NAME_LEN	32U
+#define SIM_HOTPLUG_CHANNEL	0x04U	/* Mux channel of the hot-plug slot */
+
+/************************** Variable Definitions *****************************/
+
+static IicSim_Device *Eeproms[IIC_SIM_NUM_BUSES][SIM_EEPROMS_PER_BUS];
+static char EepromNames[IIC_SIM_NUM_BUSES][SIM_EEPROM_NAME_LEN];
+
+/************************** Function Definitions *****************************/
+
+/*****************************************************************************/
+/**
+* Builds the simulated board the first time it is called.
+*
+* @param	None.
+*
+* @return	None.
+*
+* @note		The report of the simulated devices is printed when the
+*		program exits.
+*
+******************************************************************************/
+void IicSim_BuildTopology(void)
+{
+	static u32 IsBuilt;
+	IicSim_Device *Mux;
+	IicSim_Device *Child;
+	const EepromSim_Profile *Profile;
+	const char *Env;
+	u32 WriteCycleUs = 0U;
+	u32 HasSecond;
+	u32 PlugPeriodUs = 0;
+	u32 IsSparse = FALSE;
+	u32 IsCascade = FALSE;
+	u8 Channel = 0x01;
+	u32 Bus;
+
+	if (IsBuilt != FALSE) {
+		return;
+	}
+	IsBuilt = TRUE;
+
+	Env = getenv("IICPS_SIM_TWR_US");
+	if (Env != NULL) {
+		WriteCycleUs = (u32)strtoul(Env, NULL, 0);
+	}
+	Env = getenv("IICPS_SIM_EEPROM");
+	Profile = EepromSim_FindProfile((Env != NULL) ? Env : SIM_EEPROM_PART);
+	if (Profile == NULL) {
+		xil_printf("sim: unknown EEPROM %s, using %s\r\n", Env,
+			   SIM_EEPROM_PART);
+		Profile = EepromSim_FindProfile(SIM_EEPROM_PART);
+	}
+	HasSecond = ((0x55U & ~((1U << Profile->BlockBits) - 1U)) != 0x54U);
+	Env = getenv("IICPS_SIM_HOTPLUG_US");
+	if (Env != NULL) {
+		PlugPeriodUs = (u32)strtoul(Env, NULL, 0);
+	}
+	Env = getenv("IICPS_SIM_BOARD");
+	if ((Env != NULL) && (strcmp(Env, "sparse") == 0)) {
+		IsSparse = TRUE;
+		Channel = 0x02;
+	}
+	if ((Env != NULL) && (strcmp(Env, "cascade") == 0)) {
+		IsCascade = TRUE;
+	}
+
+	for (Bus = 0; Bus < IIC_SIM_NUM_BUSES; Bus++) {
+		snprintf(EepromNames[Bus], sizeof(EepromNames[Bus]), "I2C%u %s",
+			 Bus, Profile->Name);
+		Mux = MuxSim_Create("TCA9548", 0x74);
+		IicSim_AttachDevice(Bus, Mux, NULL, 0U);
+		if ((IsSparse != FALSE) && (Bus == 0U)) {
+			continue;
+		}
+
+		if ((IsCascade != FALSE) && (Bus == 0U)) {
+			Child = MuxSim_Create("TCA9548", 0x75);
+			IicSim_AttachDevice(Bus, Child, Mux, 0x02);
+			Eeproms[Bus][0] = EepromSim_Create(EepromNames[Bus], 0x54,
+							   Profile,
+							   WriteCycleUs);
+			IicSim_AttachDevice(Bus, Eeproms[Bus][0], Child, 0x01);
+			if (HasSecond == FALSE) {
+				continue;
+			}
+			Eeproms[Bus][1] = EepromSim_Create(EepromNames[Bus], 0x55,
+							   Profile,
+							   WriteCycleUs);
+			IicSim_AttachDevice(Bus, Eeproms[Bus][1], Child, 0x02);
+			continue;
+		}
+
+		Eeproms[Bus][0] = EepromSim_Create(EepromNames[Bus], 0x54,
+						   Profile, WriteCycleUs);
+		IicSim_AttachDevice(Bus, Eeproms[Bus][0], Mux, Channel);
+		if (HasSecond == FALSE) {
+			continue;
+		}
+
+		Eeproms[Bus][1] = EepromSim_Create(EepromNames[Bus], 0x55,
+						   Profile, WriteCycleUs);
+		if ((Bus == (IIC_SIM_NUM_BUSES - 1U)) && (PlugPeriodUs != 0U)) {
+			Eeproms[Bus][1]->PlugPeriodUs = PlugPeriodUs;
+			IicSim_AttachDevice(Bus, Eeproms[Bus][1], Mux,
+					    SIM_HOTPLUG_CHANNEL);
+			continue;
+		}
+		IicSim_AttachDevice(Bus, Eeproms[Bus][1], Mux, Channel);
+	}
+
+	atexit(IicSim_Report);
+}
+
+/*****************************************************************************/
+/**
+* Prints the simulated time and the statistics of the simulated buses and
+* devices.
+*
+******************************************************************************/
+void IicSim_Report(void)
+{
+	u32 Bus, Index;
+
+	xil_printf("sim: %u us elapsed, run in %u us\r\n", (u32)IicSim_NowUs(),
+		   (u32)IicSim_HostUs());
+	for (Bus = 0; Bus < IIC_SIM_NUM_BUSES; Bus++) {
+		IicSim_ReportBus(Bus);
+		for (Index = 0; Index < SIM_EEPROMS_PER_BUS; Index++) {
+			if (Eeproms[Bus][Index] != NULL) {
+				EepromSim_Report(Eeproms[Bus][Index]);
+			}
+		}
+	}
+}
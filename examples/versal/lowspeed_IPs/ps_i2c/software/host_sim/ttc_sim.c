@@ -0,0 +1,199 @@
+/******************************************************************************
+* Copyright (C) 2021 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file ttc_sim.c
+*
+* Implementation of the XTtcPs driver interface for counter 0 of TTC0. The
+* counter is not stepped, its value follows from the simulated time since it
+* was started or reset. In interval mode it reaches the interval once every
+* interval, which sets the interval bit of the interrupt status register.
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include "xparameters.h"
+#include "xttcps.h"
+#include "iic_sim.h"
+
+/**************************** Type Definitions *******************************/
+
+typedef struct {
+	u32 Running;		/* Counter started */
+	u32 Options;		/* XTTCPS_OPTION_* set */
+	u32 Ier;		/* Enabled interrupts */
+	u32 Isr;		/* Interrupt status register */
+	u32 Prescaler;		/* Input clock divider */
+	XInterval Interval;	/* Interval in counts */
+	u64 StartNs;		/* Time the counter was last at 0 */
+} IicSim_Ttc;
+
+/************************** Variable Definitions *****************************/
+
+static XTtcPs_Config XTtcPs_ConfigTable[] = {
+	{
+		XPAR_XTTCPS_0_DEVICE_ID,
+		XPAR_XTTCPS_0_BASEADDR,
+		XPAR_XTTCPS_0_TTC_CLK_FREQ_HZ
+	}
+};
+
+static IicSim_Ttc Ttc;
+
+/************************** Function Definitions *****************************/
+
+/*****************************************************************************/
+/**
+* Returns the length of an interval of the counter in nanoseconds.
+*
+******************************************************************************/
+static u64 IicSim_TtcPeriodNs(void)
+{
+	return ((u64)Ttc.Interval + 1U) * Ttc.Prescaler * 1000000000U /
+		XPAR_XTTCPS_0_TTC_CLK_FREQ_HZ;
+}
+
+/*****************************************************************************/
+/**
+* Returns TRUE while the counter raises the interrupt ID, that is it has an
+* enabled interrupt status bit set.
+*
+* @param	IntId is the interrupt ID.
+*
+* @return	TRUE if the interrupt is raised, else FALSE.
+*
+* @note		The interval bit is set first if an interval has passed.
+*
+******************************************************************************/
+u32 IicSim_TimerIrqIsRaised(u32 IntId)
+{
+	u64 PeriodNs;
+	u64 NowNs;
+
+	if (IntId != XPAR_XTTCPS_0_INTR) {
+		return FALSE;
+	}
+
+	if ((Ttc.Running != FALSE) &&
+	    ((Ttc.Options & XTTCPS_OPTION_INTERVAL_MODE) != 0U)) {
+		PeriodNs = IicSim_TtcPeriodNs();
+		NowNs = IicSim_NowNs();
+		if (NowNs - Ttc.StartNs >= PeriodNs) {
+			Ttc.Isr |= XTTCPS_IXR_INTERVAL_MASK;
+			Ttc.StartNs += ((NowNs - Ttc.StartNs) / PeriodNs) *
+				       PeriodNs;
+		}
+	}
+
+	return ((Ttc.Isr & Ttc.Ier) != 0U) ? TRUE : FALSE;
+}
+
+XTtcPs_Config *XTtcPs_LookupConfig(u16 DeviceId)
+{
+	if (DeviceId == XTtcPs_ConfigTable[0].DeviceId) {
+		return &XTtcPs_ConfigTable[0];
+	}
+
+	return NULL;
+}
+
+s32 XTtcPs_CfgInitialize(XTtcPs *InstancePtr, XTtcPs_Config *ConfigPtr,
+			 u32 EffectiveAddr)
+{
+	InstancePtr->Config = *ConfigPtr;
+	InstancePtr->Config.BaseAddress = EffectiveAddr;
+	InstancePtr->IsReady = XIL_COMPONENT_IS_READY;
+
+	Ttc.Running = FALSE;
+	Ttc.Options = 0U;
+	Ttc.Ier = 0U;
+	Ttc.Isr = 0U;
+	Ttc.Prescaler = 1U;
+	Ttc.Interval = XTTCPS_MAX_INTERVAL_COUNT;
+
+	return XST_SUCCESS;
+}
+
+s32 XTtcPs_SetOptions(XTtcPs *InstancePtr, u32 Options)
+{
+	(void)InstancePtr;
+
+	Ttc.Options = Options;
+
+	return XST_SUCCESS;
+}
+
+void XTtcPs_SetPrescaler(XTtcPs *InstancePtr, u8 PrescalerValue)
+{
+	(void)InstancePtr;
+
+	/*
+	 * 0 to 15 divide the clock by 2^(n+1), larger values do not divide.
+	 */
+	Ttc.Prescaler = (PrescalerValue < 16U) ? (2U << PrescalerValue) : 1U;
+}
+
+void XTtcPs_SetInterval(XTtcPs *InstancePtr, XInterval Value)
+{
+	(void)InstancePtr;
+
+	Ttc.Interval = Value;
+}
+
+void XTtcPs_ResetCounterValue(XTtcPs *InstancePtr)
+{
+	(void)InstancePtr;
+
+	Ttc.StartNs = IicSim_NowNs();
+}
+
+void XTtcPs_Start(XTtcPs *InstancePtr)
+{
+	(void)InstancePtr;
+
+	if (Ttc.Running == FALSE) {
+		Ttc.StartNs = IicSim_NowNs();
+		Ttc.Running = TRUE;
+	}
+}
+
+void XTtcPs_Stop(XTtcPs *InstancePtr)
+{
+	(void)InstancePtr;
+
+	Ttc.Running = FALSE;
+}
+
+void XTtcPs_EnableInterrupts(XTtcPs *InstancePtr, u32 InterruptMask)
+{
+	(void)InstancePtr;
+
+	Ttc.Ier |= InterruptMask & XTTCPS_IXR_ALL_MASK;
+}
+
+void XTtcPs_DisableInterrupts(XTtcPs *InstancePtr, u32 InterruptMask)
+{
+	(void)InstancePtr;
+
+	Ttc.Ier &= ~InterruptMask;
+}
+
+u32 XTtcPs_GetInterruptStatus(XTtcPs *InstancePtr)
+{
+	(void)InstancePtr;
+
+	(void)IicSim_TimerIrqIsRaised(XPAR_XTTCPS_0_INTR);
+
+	return Ttc.Isr;
+}
+
+void XTtcPs_ClearInterruptStatus(XTtcPs *InstancePtr, u32 InterruptMask)
+{
+	(void)InstancePtr;
+
+	Ttc.Isr &= ~InterruptMask;
+}
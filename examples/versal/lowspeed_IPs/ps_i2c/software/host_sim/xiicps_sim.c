@@ -0,0 +1,440 @@
+/******************************************************************************
+* Copyright (C) 2021 Xilinx, Inc.  All rights reserved.
+* SPDX-License-Identifier: MIT
+******************************************************************************/
+
+/*****************************************************************************/
+/**
+* @file xiicps_sim.c
+*
+* Implementation of the XIicPs driver interface on top of the simulated
+* buses. Each controller keeps the register state the examples look at: the
+* interrupt status bits, the hold bit used for repeated starts and the slave
+* monitor.
+*
+* The slave monitor is evaluated when the interrupt status register is read,
+* which is when the hardware result would become visible to software, and
+* when the processor looks for raised interrupts.
+*
+* The interrupt mode transfers complete at once and leave their status in
+* the interrupt status register. The unmasked status bits raise the
+* interrupt line of the controller, and XIicPs_MasterInterruptHandler()
+* turns them into the events passed to the status handler.
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+
+#include <string.h>
+#include "xparameters.h"
+#include "xiicps.h"
+#include "iic_sim.h"
+
+/**************************** Type Definitions *******************************/
+
+typedef struct {
+	u32 Isr;		/* Interrupt status register */
+	u32 Imr;		/* Interrupt mask register, 1 = masked */
+	u32 Cr;			/* Control register */
+	u32 SlvMonActive;	/* Slave monitor running */
+	u32 SlvMonDone;		/* Monitored slave answered */
+	u16 SlvMonAddr;		/* Address polled by the slave monitor */
+	u32 SClkHz;		/* Serial clock rate */
+} IicSim_Controller;
+
+/************************** Variable Definitions *****************************/
+
+static XIicPs_Config XIicPs_ConfigTable[XPAR_XIICPS_NUM_INSTANCES] = {
+	{
+		XPAR_XIICPS_0_DEVICE_ID,
+		XPAR_XIICPS_0_BASEADDR,
+		XPAR_XIICPS_0_I2C_CLK_FREQ_HZ
+	},
+	{
+		XPAR_XIICPS_1_DEVICE_ID,
+		XPAR_XIICPS_1_BASEADDR,
+		XPAR_XIICPS_1_I2C_CLK_FREQ_HZ
+	}
+};
+
+static IicSim_Controller Controllers[XPAR_XIICPS_NUM_INSTANCES];
+
+/*
+ * Interrupt ID raised by each controller. The lines are wired the way the
+ * examples connect them, see IIC_INTR_ID() in the interrupt example.
+ */
+static const u32 IntrIds[XPAR_XIICPS_NUM_INSTANCES] = {
+	XPAR_XIICPS_1_INTR, XPAR_XIICPS_0_INTR
+};
+
+/************************** Function Definitions *****************************/
+
+/*****************************************************************************/
+/**
+* Maps a controller base address to its bus index.
+*
+******************************************************************************/
+static u32 IicSim_BusIndex(UINTPTR BaseAddress)
+{
+	u32 Index;
+
+	for (Index = 0U; Index < XPAR_XIICPS_NUM_INSTANCES; Index++) {
+		if (XIicPs_ConfigTable[Index].BaseAddress == BaseAddress) {
+			return Index;
+		}
+	}
+
+	return 0U;
+}
+
+/*****************************************************************************/
+/**
+* Runs one slave monitor poll and flags the slave ready interrupt once the
+* monitored slave acknowledges its address.
+*
+******************************************************************************/
+static void IicSim_SlaveMonitorPoll(u32 Bus)
+{
+	IicSim_Controller *Ctrl = &Controllers[Bus];
+
+	if ((Ctrl->SlvMonActive == FALSE) || (Ctrl->SlvMonDone != FALSE)) {
+		return;
+	}
+
+	if (IicSim_Probe(Bus, Ctrl->SlvMonAddr) == IIC_SIM_ACK) {
+		Ctrl->Isr |= XIICPS_IXR_SLV_RDY_MASK;
+		Ctrl->SlvMonDone = TRUE;
+	}
+}
+
+/*****************************************************************************/
+/**
+* Returns TRUE while a controller raises the interrupt ID, that is it has an
+* unmasked interrupt status bit set.
+*
+* @param	IntId is the interrupt ID.
+*
+* @return	TRUE if the interrupt is raised, else FALSE.
+*
+* @note		The slave monitor is polled first.
+*
+******************************************************************************/
+u32 IicSim_IrqIsRaised(u32 IntId)
+{
+	IicSim_Controller *Ctrl;
+	u32 Bus;
+
+	for (Bus = 0U; Bus < XPAR_XIICPS_NUM_INSTANCES; Bus++) {
+		if (IntrIds[Bus] != IntId) {
+			continue;
+		}
+		Ctrl = &Controllers[Bus];
+		if ((Ctrl->Imr & XIICPS_IXR_SLV_RDY_MASK) == 0U) {
+			IicSim_SlaveMonitorPoll(Bus);
+		}
+		return ((Ctrl->Isr & ~Ctrl->Imr & XIICPS_IXR_ALL_INTR_MASK) !=
+			0U) ? TRUE : FALSE;
+	}
+
+	return FALSE;
+}
+
+u32 IicSim_ReadReg(UINTPTR BaseAddress, u32 RegOffset)
+{
+	u32 Bus = IicSim_BusIndex(BaseAddress);
+	IicSim_Controller *Ctrl = &Controllers[Bus];
+
+	IicSim_CpuPoll();
+
+	switch (RegOffset) {
+	case XIICPS_CR_OFFSET:
+		return Ctrl->Cr;
+	case XIICPS_SR_OFFSET:
+		return (IicSim_BusIsHeld(Bus) != FALSE) ? XIICPS_SR_BA_MASK : 0U;
+	case XIICPS_ISR_OFFSET:
+		IicSim_SlaveMonitorPoll(Bus);
+		return Ctrl->Isr;
+	case XIICPS_IMR_OFFSET:
+		return Ctrl->Imr;
+	default:
+		return 0U;
+	}
+}
+
+void IicSim_WriteReg(UINTPTR BaseAddress, u32 RegOffset, u32 RegisterValue)
+{
+	IicSim_Controller *Ctrl = &Controllers[IicSim_BusIndex(BaseAddress)];
+
+	switch (RegOffset) {
+	case XIICPS_CR_OFFSET:
+		Ctrl->Cr = RegisterValue;
+		break;
+	case XIICPS_ISR_OFFSET:
+		Ctrl->Isr &= ~RegisterValue;
+		break;
+	case XIICPS_IER_OFFSET:
+		Ctrl->Imr &= ~RegisterValue;
+		break;
+	case XIICPS_IDR_OFFSET:
+		Ctrl->Imr |= RegisterValue;
+		break;
+	default:
+		break;
+	}
+}
+
+XIicPs_Config *XIicPs_LookupConfig(u16 DeviceId)
+{
+	u32 Index;
+
+	IicSim_BuildTopology();
+
+	for (Index = 0U; Index < XPAR_XIICPS_NUM_INSTANCES; Index++) {
+		if (XIicPs_ConfigTable[Index].DeviceId == DeviceId) {
+			return &XIicPs_ConfigTable[Index];
+		}
+	}
+
+	return NULL;
+}
+
+s32 XIicPs_CfgInitialize(XIicPs *InstancePtr, XIicPs_Config *ConfigPtr,
+				  u32 EffectiveAddr)
+{
+	IicSim_Controller *Ctrl;
+
+	memset(InstancePtr, 0, sizeof(*InstancePtr));
+	InstancePtr->Config.DeviceId = ConfigPtr->DeviceId;
+	InstancePtr->Config.BaseAddress = EffectiveAddr;
+	InstancePtr->Config.InputClockHz = ConfigPtr->InputClockHz;
+	InstancePtr->IsReady = XIL_COMPONENT_IS_READY;
+
+	XIicPs_Reset(InstancePtr);
+
+	Ctrl = &Controllers[IicSim_BusIndex(EffectiveAddr)];
+	Ctrl->SClkHz = IIC_SIM_SCLK_HZ;
+	IicSim_SetSClk(IicSim_BusIndex(EffectiveAddr), Ctrl->SClkHz);
+
+	return XST_SUCCESS;
+}
+
+void XIicPs_Reset(XIicPs *InstancePtr)
+{
+	u32 Bus = IicSim_BusIndex(InstancePtr->Config.BaseAddress);
+	IicSim_Controller *Ctrl = &Controllers[Bus];
+
+	IicSim_ReleaseBus(Bus);
+	Ctrl->Isr = 0U;
+	Ctrl->Imr = XIICPS_IXR_ALL_INTR_MASK;
+	Ctrl->Cr = 0U;
+	Ctrl->SlvMonActive = FALSE;
+	Ctrl->SlvMonDone = FALSE;
+	InstancePtr->Options = 0U;
+	InstancePtr->IsRepeatedStart = 0;
+}
+
+void XIicPs_Abort(XIicPs *InstancePtr)
+{
+	XIicPs_Reset(InstancePtr);
+}
+
+/*****************************************************************************/
+/**
+* Carries out a master transfer and updates the interrupt status register
+* the way the controller would.
+*
+******************************************************************************/
+static s32 IicSim_MasterTransfer(XIicPs *InstancePtr, u8 *MsgPtr,
+				 s32 ByteCount, u16 SlaveAddr, u32 IsRead)
+{
+	u32 Bus = IicSim_BusIndex(InstancePtr->Config.BaseAddress);
+	IicSim_Controller *Ctrl = &Controllers[Bus];
+	s32 Result;
+
+	InstancePtr->IsSend = (IsRead == FALSE) ? 1 : 0;
+	Result = IicSim_Transfer(Bus, SlaveAddr, IsRead, MsgPtr,
+				 (u32)ByteCount,
+				 (u32)InstancePtr->IsRepeatedStart);
+	if (Result != IIC_SIM_ACK) {
+		Ctrl->Isr |= XIICPS_IXR_NACK_MASK;
+		return XST_FAILURE;
+	}
+
+	Ctrl->Isr |= XIICPS_IXR_COMP_MASK;
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* Starts an interrupt mode transfer. The transfer is carried out at once, its
+* completion or NACK is left in the interrupt status register with the
+* interrupts the driver would enable for it unmasked.
+*
+******************************************************************************/
+static void IicSim_MasterStart(XIicPs *InstancePtr, u8 *MsgPtr,
+			       s32 ByteCount, u16 SlaveAddr, u32 IsRead)
+{
+	IicSim_Controller *Ctrl =
+		&Controllers[IicSim_BusIndex(InstancePtr->Config.BaseAddress)];
+	u32 Mask = XIICPS_IXR_NACK_MASK | XIICPS_IXR_COMP_MASK |
+		   XIICPS_IXR_ARB_LOST_MASK;
+
+	if (IsRead != FALSE) {
+		InstancePtr->RecvBufferPtr = MsgPtr;
+		InstancePtr->RecvByteCount = 0;
+		Mask |= XIICPS_IXR_DATA_MASK | XIICPS_IXR_RX_OVR_MASK;
+	} else {
+		InstancePtr->SendBufferPtr = MsgPtr;
+		InstancePtr->SendByteCount = 0;
+	}
+
+	Ctrl->Isr = 0U;
+	Ctrl->Imr &= ~Mask;
+	(void)IicSim_MasterTransfer(InstancePtr, MsgPtr, ByteCount, SlaveAddr,
+				    IsRead);
+}
+
+void XIicPs_MasterSend(XIicPs *InstancePtr, u8 *MsgPtr, s32 ByteCount,
+		 u16 SlaveAddr)
+{
+	IicSim_MasterStart(InstancePtr, MsgPtr, ByteCount, SlaveAddr, FALSE);
+}
+
+void XIicPs_MasterRecv(XIicPs *InstancePtr, u8 *MsgPtr, s32 ByteCount,
+		 u16 SlaveAddr)
+{
+	IicSim_MasterStart(InstancePtr, MsgPtr, ByteCount, SlaveAddr, TRUE);
+}
+
+s32 XIicPs_MasterSendPolled(XIicPs *InstancePtr, u8 *MsgPtr, s32 ByteCount,
+		 u16 SlaveAddr)
+{
+	return IicSim_MasterTransfer(InstancePtr, MsgPtr, ByteCount,
+				     SlaveAddr, FALSE);
+}
+
+s32 XIicPs_MasterRecvPolled(XIicPs *InstancePtr, u8 *MsgPtr, s32 ByteCount,
+		 u16 SlaveAddr)
+{
+	return IicSim_MasterTransfer(InstancePtr, MsgPtr, ByteCount,
+				     SlaveAddr, TRUE);
+}
+
+void XIicPs_EnableSlaveMonitor(XIicPs *InstancePtr, u16 SlaveAddr)
+{
+	IicSim_Controller *Ctrl =
+		&Controllers[IicSim_BusIndex(InstancePtr->Config.BaseAddress)];
+
+	Ctrl->Cr |= XIICPS_CR_SLVMON_MASK;
+	Ctrl->Isr &= ~XIICPS_IXR_SLV_RDY_MASK;
+	Ctrl->Imr &= ~XIICPS_IXR_SLV_RDY_MASK;
+	Ctrl->SlvMonAddr = SlaveAddr;
+	Ctrl->SlvMonActive = TRUE;
+	Ctrl->SlvMonDone = FALSE;
+}
+
+void XIicPs_DisableSlaveMonitor(XIicPs *InstancePtr)
+{
+	IicSim_Controller *Ctrl =
+		&Controllers[IicSim_BusIndex(InstancePtr->Config.BaseAddress)];
+
+	Ctrl->Cr &= ~XIICPS_CR_SLVMON_MASK;
+	Ctrl->Imr |= XIICPS_IXR_SLV_RDY_MASK;
+	Ctrl->SlvMonActive = FALSE;
+}
+
+s32 XIicPs_BusIsBusy(XIicPs *InstancePtr)
+{
+	IicSim_CpuPoll();
+
+	return (s32)IicSim_BusIsHeld(
+			IicSim_BusIndex(InstancePtr->Config.BaseAddress));
+}
+
+void XIicPs_SetStatusHandler(XIicPs *InstancePtr, void *CallBackRef,
+			     XIicPs_IntrHandler FunctionPtr)
+{
+	InstancePtr->CallBackRef = CallBackRef;
+	InstancePtr->StatusHandler = FunctionPtr;
+}
+
+/*****************************************************************************/
+/**
+* Interrupt handler of a controller. The unmasked interrupt status bits are
+* cleared and reported to the status handler as driver events.
+*
+******************************************************************************/
+void XIicPs_MasterInterruptHandler(XIicPs *InstancePtr)
+{
+	IicSim_Controller *Ctrl =
+		&Controllers[IicSim_BusIndex(InstancePtr->Config.BaseAddress)];
+	u32 IntrStatus = Ctrl->Isr & ~Ctrl->Imr;
+	u32 StatusEvent = 0U;
+
+	Ctrl->Isr &= ~IntrStatus;
+
+	if ((IntrStatus & XIICPS_IXR_COMP_MASK) != 0U) {
+		StatusEvent |= (InstancePtr->IsSend != 0) ?
+			XIICPS_EVENT_COMPLETE_SEND : XIICPS_EVENT_COMPLETE_RECV;
+	}
+	if ((IntrStatus & XIICPS_IXR_NACK_MASK) != 0U) {
+		StatusEvent |= XIICPS_EVENT_NACK;
+	}
+	if ((IntrStatus & XIICPS_IXR_ARB_LOST_MASK) != 0U) {
+		StatusEvent |= XIICPS_EVENT_ARB_LOST;
+	}
+	if ((IntrStatus & XIICPS_IXR_TO_MASK) != 0U) {
+		StatusEvent |= XIICPS_EVENT_TIME_OUT;
+	}
+	if ((IntrStatus & XIICPS_IXR_SLV_RDY_MASK) != 0U) {
+		StatusEvent |= XIICPS_EVENT_SLAVE_RDY;
+	}
+	if ((IntrStatus & XIICPS_IXR_RX_OVR_MASK) != 0U) {
+		StatusEvent |= XIICPS_EVENT_RX_OVR;
+	}
+
+	if ((StatusEvent != 0U) && (InstancePtr->StatusHandler != NULL)) {
+		InstancePtr->StatusHandler(InstancePtr->CallBackRef,
+					   StatusEvent);
+	}
+}
+
+s32 XIicPs_SetOptions(XIicPs *InstancePtr, u32 Options)
+{
+	InstancePtr->Options |= Options;
+	if ((Options & XIICPS_REP_START_OPTION) != 0U) {
+		InstancePtr->IsRepeatedStart = 1;
+	}
+
+	return XST_SUCCESS;
+}
+
+s32 XIicPs_ClearOptions(XIicPs *InstancePtr, u32 Options)
+{
+	InstancePtr->Options &= ~Options;
+	if ((Options & XIICPS_REP_START_OPTION) != 0U) {
+		InstancePtr->IsRepeatedStart = 0;
+	}
+
+	return XST_SUCCESS;
+}
+
+u32 XIicPs_GetOptions(XIicPs *InstancePtr)
+{
+	return InstancePtr->Options;
+}
+
+s32 XIicPs_SetSClk(XIicPs *InstancePtr, u32 FsclHz)
+{
+	u32 Bus = IicSim_BusIndex(InstancePtr->Config.BaseAddress);
+
+	Controllers[Bus].SClkHz = FsclHz;
+	IicSim_SetSClk(Bus, FsclHz);
+
+	return XST_SUCCESS;
+}
+
+u32 XIicPs_GetSClk(XIicPs *InstancePtr)
+{
+	return Controllers[IicSim_BusIndex(InstancePtr->Config.BaseAddress)].SClkHz;
+}
@@ -42,6 +42,34 @@
 *		      boards, scanning for eeprom until found on all I2C
 *		      instances
 *        rna  03/26/20 Eeprom page size detection support is added.
+* 3.12  ag   10/16/26 Added ACK polling for the EEPROM write cycle.
+*                     Read the EEPROM with a repeated start after the address.
+*                     Verify the EEPROM with a single sequential read.
+*                     Added EepromWrite() for writes of any offset and length.
+*                     Added a write-back RAM cache of the EEPROM.
+*                     Skip page writes that would not change the EEPROM.
+*                     Pipelined page writes across several EEPROMs.
+*                     Drive all the PS IIC controllers concurrently.
+*                     Added an asynchronous request queue, EepromSubmit().
+*                     Sleep in WFI while waiting for transfers to complete.
+*                     Bound the slave monitor probes by a timeout in us.
+*                     Start from the saved topology of the last EEPROM search.
+*                     Added a bus enumerator building a device table.
+*                     Detect the page size with one write, restoring the
+*                     contents, and cache it per EEPROM.
+*                     Probe sessions set up each controller and the GIC
+*                     only once.
+*                     Track the mux channels and skip redundant selects.
+*                     Detect the word address width, block select bits
+*                     and capacity, and size the tests to the EEPROM.
+*                     Search all the controllers for the EEPROM at once.
+*                     Added a low duty cycle hot-plug monitor.
+*                     Route through cascaded muxes, writing changed levels only.
+*                     Reconnect the interrupt of a controller the monitor probes.
+*                     Skip the block select addresses of a pipelined EEPROM.
+*                     Go on past an EEPROM unplugged since the bus scan.
+*                     Added a benchmark of the EEPROM paths, EEPROM_BENCHMARK.
+*                     Added transaction latency histograms and bus counters.
 * </pre>
 *
 ******************************************************************************/
@@ -55,6 +83,11 @@
 #include "xil_exception.h"
 #include "xil_printf.h"
 #include "xplatform_info.h"
+#include "xtime_l.h"
+#include "xpseudo_asm.h"
+#ifdef XPAR_XTTCPS_0_DEVICE_ID
+#include "xttcps.h"
+#endif
 
 /************************** Constant Definitions *****************************/
 
@@ -66,6 +99,16 @@
 
 #define INTC_DEVICE_ID	XPAR_SCUGIC_SINGLE_DEVICE_ID
 
+/*
+ * Wakeup timer. With a TTC in the design, counter 0 of TTC0 ends a WFI at
+ * the deadline of a wait for the slave monitor, see IicPsWaitEventUntil().
+ * Without one these waits spin.
+ */
+#ifdef XPAR_XTTCPS_0_DEVICE_ID
+#define TTC_DEVICE_ID	XPAR_XTTCPS_0_DEVICE_ID
+#define TTC_INTR_ID	XPAR_XTTCPS_0_INTR
+#endif
+
 /*
  * The following constant defines the address of the IIC Slave device on the
  * IIC bus. Note that since the address is only 7 bits, this constant is the
@@ -73,7 +116,6 @@
  */
 
 #define IIC_SCLK_RATE		100000
-#define SLV_MON_LOOP_COUNT 0x000FFFFF	/**< Slave Monitor Loop Count*/
 #define MUX_ADDR 0x74
 #define MAX_CHANNELS 0x08
 
@@ -82,6 +124,7 @@
  * The write function should be called with this as a maximum byte count.
  */
 #define MAX_SIZE		64
+#define PAGE_SIZE_8	8
 #define PAGE_SIZE_16	16
 #define PAGE_SIZE_32	32
 #define PAGE_SIZE_64	64
@@ -91,6 +134,181 @@
  */
 #define EEPROM_START_ADDRESS	0
 
+/*
+ * Time a slave monitor probe waits for the addressed slave to acknowledge.
+ * The slave monitor repeats the address every few SCL periods, so a present
+ * slave answers within a fraction of this even at 100 kHz.
+ */
+#ifndef SLV_MON_TIMEOUT_US
+#define SLV_MON_TIMEOUT_US	1000
+#endif
+
+#define EEPROM_TOPOLOGY_MAGIC	0x45455450	/**< "EETP" */
+
+/*
+ * Bus enumeration. The 7-bit addresses from IIC_ENUM_FIRST_ADDR to
+ * IIC_ENUM_LAST_ADDR are probed with IIC_ENUM_TIMEOUT_US each, and up to
+ * IIC_DEVICE_TABLE_SIZE responding devices are recorded.
+ */
+#define IIC_ENUM_FIRST_ADDR	0x08
+#define IIC_ENUM_LAST_ADDR	0x77
+#define IIC_ENUM_TIMEOUT_US	300
+#define IIC_DEVICE_TABLE_SIZE	64
+
+/*
+ * Hot-plug monitor. IicPsMonitorPoll() probes one entry of DeviceTable every
+ * IIC_MONITOR_PERIOD_US at most, each for IIC_MONITOR_TIMEOUT_US, and pauses
+ * long enough after every probe that the monitor takes no more than
+ * IIC_MONITOR_DUTY_PERMILLE of the bus time. A device is taken as detached
+ * after IIC_MONITOR_MISSES unanswered probes in a row, so an EEPROM busy
+ * with a write cycle is not reported. The example runs the monitor next to
+ * foreground reads for IIC_MONITOR_EXAMPLE_US.
+ */
+#define IIC_MONITOR_PERIOD_US		5000
+#define IIC_MONITOR_TIMEOUT_US		IIC_ENUM_TIMEOUT_US
+#define IIC_MONITOR_DUTY_PERMILLE	20
+#define IIC_MONITOR_MISSES		2
+#define IIC_MONITOR_EXAMPLE_US		1000000
+
+#define IIC_MONITOR_ATTACH	1	/**< Device answers again */
+#define IIC_MONITOR_DETACH	2	/**< Device stopped answering */
+
+/*
+ * Value of ActiveDeviceId while IicInstance is set up for no controller.
+ */
+#define IIC_NO_SESSION		0xFFFFU
+
+/*
+ * States of the EEPROM search on one controller, see IicPsDiscoverStep().
+ * Behind a mux the EEPROM addresses are first probed with all the channels
+ * open, IIC_ALL_CHANNELS, and only an address that answers is looked for
+ * channel by channel.
+ */
+#define IIC_SEARCH_START	0	/**< Not started */
+#define IIC_SEARCH_MUX		1	/**< Probing MuxAddr[SearchMux] */
+#define IIC_SEARCH_BEHIND	2	/**< Probing behind all the channels */
+#define IIC_SEARCH_CHANNEL	3	/**< Probing behind SearchChannel */
+#define IIC_SEARCH_ROOT		4	/**< Probing the root segment */
+#define IIC_SEARCH_DONE		5	/**< Search over */
+#define IIC_ALL_CHANNELS	((MAX_CHANNELS << 1) - 1)
+
+/*
+ * Mux channel tracking. MuxInitChannel() remembers the channel selected on
+ * up to IIC_MUX_STATE_SIZE muxes and skips selecting it again. With
+ * MUX_VERIFY_SELECT the channel byte is read back after every select.
+ */
+#define IIC_MUX_STATE_SIZE	8
+#ifndef MUX_VERIFY_SELECT
+#define MUX_VERIFY_SELECT	TRUE
+#endif
+
+/*
+ * Cascaded muxes. A mux listed in MuxTree[] sits behind a channel of another
+ * mux, and MuxRoute() opens the path to it through at most IIC_MUX_MAX_DEPTH
+ * muxes. Build with IIC_MUX_CASCADE for a second mux behind channel 1 of the
+ * first one.
+ */
+#define IIC_MUX_MAX_DEPTH	4
+
+/*
+ * Geometry detection. EEPROM_GEOMETRY_CACHE_SIZE EEPROMs are remembered by
+ * EepromGetGeometry(). EEPROM_BUSY_PROBE_US bounds the probes that check
+ * whether a write cycle has started, it has to be well below tWR.
+ * EEPROM_DEFAULT_SIZE is assumed for an EEPROM that is not detected.
+ */
+#define EEPROM_GEOMETRY_CACHE_SIZE	8
+#define EEPROM_BUSY_PROBE_US		200
+#define EEPROM_DEFAULT_SIZE		(256 * PAGE_SIZE_32)
+
+/*
+ * Write cycle completion modes. With EEPROM_WAIT_FIXED_DELAY every write is
+ * followed by a delay of EEPROM_WRITE_DELAY_US. With EEPROM_WAIT_ACK_POLL the
+ * slave monitor re-addresses the EEPROM until it acknowledges again, which
+ * it only does once the internal write cycle (tWR, typically 5 ms) is over.
+ * EEPROM_WRITE_TIMEOUT_US bounds the polling.
+ */
+#define EEPROM_WAIT_FIXED_DELAY	0
+#define EEPROM_WAIT_ACK_POLL	1
+
+#ifndef EEPROM_WRITE_WAIT_MODE
+#define EEPROM_WRITE_WAIT_MODE	EEPROM_WAIT_ACK_POLL
+#endif
+#define EEPROM_WRITE_DELAY_US	250000
+#define EEPROM_WRITE_TIMEOUT_US	20000
+
+/*
+ * Write-back cache of the EEPROM. The first EEPROM_CACHE_SIZE bytes are
+ * mirrored in RAM and updated pages are marked dirty. Dirty pages are written
+ * back by EepromCacheFlush(), which EepromCachePoll() calls once
+ * EEPROM_CACHE_DIRTY_LIMIT pages are dirty or the oldest pending update is
+ * EEPROM_CACHE_FLUSH_US old.
+ */
+#define EEPROM_CACHE_SIZE		(256 * MAX_SIZE)
+#define EEPROM_CACHE_MAX_PAGES		(EEPROM_CACHE_SIZE / PAGE_SIZE_8)
+#define EEPROM_CACHE_DIRTY_LIMIT	16
+#define EEPROM_CACHE_FLUSH_US		100000
+
+/*
+ * When set, EepromWrite() compares every page with the EEPROM contents, taken
+ * from the cache when it holds them, and skips the write cycle of pages that
+ * would not change. This saves write endurance, but a page that is not in
+ * the cache is read before it is written, which costs about as much bus time
+ * as the write cycle it may save. Off by default, set it for data that is
+ * mostly rewritten unchanged or with the cache loaded.
+ */
+#define EEPROM_COMPARE_BEFORE_WRITE	FALSE
+
+/*
+ * Pipelined writes. EEPROM_MAX_DEVICES bounds the number of EEPROMs written
+ * together and EEPROM_PIPELINE_PAGES is the number of pages the example
+ * writes to each of them.
+ */
+#define EEPROM_MAX_DEVICES	4
+#define EEPROM_PIPELINE_PAGES	32
+
+/*
+ * Benchmark, built with EEPROM_BENCHMARK in place of the example, see
+ * IicPsEepromBenchmark(). Up to BENCH_MAX_OPS operations of a workload are
+ * timed. The sequential verify reads BENCH_VERIFY_CHUNK bytes at a time and
+ * the random workloads move 1 to BENCH_RANDOM_MAX_BYTES bytes at a time.
+ */
+#define BENCH_MAX_OPS		(256 * MAX_SIZE / PAGE_SIZE_8)
+#define BENCH_VERIFY_CHUNK	256
+#define BENCH_RANDOM_WRITES	64
+#define BENCH_RANDOM_READS	256
+#define BENCH_RANDOM_MAX_BYTES	MAX_SIZE
+#define BENCH_DISCOVERY_RUNS	8
+
+/*
+ * Transaction statistics, see IicPsStatsRecord(). The latencies of each kind
+ * of transaction are counted in IIC_STATS_BUCKETS buckets: bucket 0 holds the
+ * ones below 1 us, bucket n the ones from 2^(n-1) us up to 2^n us and the
+ * last bucket all longer ones.
+ */
+#define IIC_STATS_SEND		0	/**< Data written to a slave */
+#define IIC_STATS_RECV		1	/**< Data read from a slave */
+#define IIC_STATS_ADDRESS	2	/**< Word address set for a read */
+#define IIC_STATS_WRITE_WAIT	3	/**< Wait for an EEPROM write cycle */
+#define IIC_STATS_MUX		4	/**< Mux channel select */
+#define IIC_STATS_PROBE		5	/**< Slave monitor probe */
+#define IIC_STATS_KINDS		6
+#define IIC_STATS_BUCKETS	20
+
+/*
+ * Asynchronous request queue. EEPROM_QUEUE_DEPTH is the number of requests
+ * that can be pending at a time and EEPROM_QUEUE_TIMEOUT_US bounds the time
+ * the example waits for all of its requests.
+ */
+#define EEPROM_QUEUE_DEPTH	8
+#define EEPROM_QUEUE_TIMEOUT_US	1000000
+
+#define EEPROM_REQ_READ		0	/**< Read request */
+#define EEPROM_REQ_WRITE	1	/**< Write request */
+
+#define EEPROM_PHASE_ADDRESS	0	/**< Word address of a read */
+#define EEPROM_PHASE_DATA	1	/**< Data of a read or write */
+#define EEPROM_PHASE_WRITE_CYCLE 2	/**< Polling for the end of tWR */
+
 /**************************** Type Definitions *******************************/
 
 /*
@@ -99,27 +317,328 @@
  */
 typedef u16 AddressType;
 
+/*
+ * Where the last EEPROM search found the EEPROM, saved with
+ * EepromTopologySave() and tried first by IicPsLocateEeprom().
+ */
+typedef struct {
+	u32 Magic;		/**< EEPROM_TOPOLOGY_MAGIC when valid */
+	u16 DeviceId;		/**< Controller of the EEPROM */
+	u16 MuxAddr;		/**< Mux in front of the EEPROM, 0 if none */
+	u16 SlvAddr;		/**< Slave address of the EEPROM */
+	u8 MuxChannel;		/**< Mux channel of the EEPROM */
+	u8 AddrBytes;		/**< Bytes of word address */
+	u32 PageSize;		/**< Page size in bytes */
+	u8 BlockMask;		/**< Block select bits of the slave address */
+	u32 Size;		/**< Capacity in bytes */
+	u32 Checksum;		/**< Inverted sum of the fields above */
+} EepromTopology;
+
+/*
+ * A device found by IicPsEnumerate().
+ */
+typedef struct {
+	u16 DeviceId;		/**< Controller of the device */
+	u16 MuxAddr;		/**< Mux in front of the device, 0 if none */
+	u8 MuxChannel;		/**< Mux channel of the device */
+	u16 Addr;		/**< 7-bit slave address */
+	u8 Responds;		/**< Acknowledged its address when last probed */
+	u8 Misses;		/**< Unanswered monitor probes in a row */
+} IicPsDeviceEntry;
+
+/*
+ * Callback of the hot-plug monitor, Event is IIC_MONITOR_ATTACH or
+ * IIC_MONITOR_DETACH.
+ */
+typedef void (*IicPsMonitorHandler)(void *CallBackRef, IicPsDeviceEntry *Entry,
+				    u32 Event);
+
+/*
+ * The channel selected on a mux, as last written by MuxInitChannel().
+ */
+typedef struct {
+	u16 DeviceId;		/**< Controller of the mux */
+	u16 MuxAddr;		/**< Address of the mux, 0 for a free entry */
+	u8 Channel;		/**< Selected channel bits */
+	u8 Valid;		/**< Channel is known */
+} IicPsMuxState;
+
+/*
+ * A mux behind a channel of another mux, see MuxRoute().
+ */
+typedef struct {
+	u16 MuxAddr;		/**< Address of the mux, 0 ends MuxTree[] */
+	u16 ParentAddr;		/**< Mux it is behind */
+	u8 ParentChannel;	/**< Channel of the parent it is behind */
+} IicPsMuxNode;
+
+/*
+ * A mux channel opened with MuxRoute().
+ */
+typedef struct {
+	u16 MuxAddr;		/**< Address of the mux, 0 if none */
+	u8 Channel;		/**< Selected channel bits */
+} IicPsMuxRoute;
+
+/*
+ * An EEPROM on the current controller, either on the root segment (MuxAddr
+ * is 0) or behind a mux channel.
+ */
+typedef struct {
+	u16 SlvAddr;		/**< 7-bit slave address */
+	u16 MuxAddr;		/**< Address of the mux, 0 if none */
+	u8 MuxChannel;		/**< Channel select value of the mux */
+	u32 PageSize;		/**< Page size in bytes */
+	u8 AddrBytes;		/**< Bytes of word address, 1 or 2 */
+	u8 BlockMask;		/**< Slave address bits selecting a 256 byte block */
+	u32 Size;		/**< Capacity in bytes */
+} EepromDevice;
+
+/*
+ * The geometry of an EEPROM detected by EepromGetGeometry(), remembered by
+ * the controller and address it was requested for.
+ */
+typedef struct {
+	u16 DeviceId;		/**< Controller of the EEPROM */
+	u16 SlvAddr;		/**< Slave address it was requested for */
+	EepromDevice Device;	/**< Detected geometry */
+} EepromGeometryEntry;
+
+/*
+ * A write to one EEPROM scheduled by EepromPipelineWrite().
+ */
+typedef struct {
+	EepromDevice *Device;	/**< Target EEPROM */
+	u16 Address;		/**< Word address of the next byte */
+	u8 *BufferPtr;		/**< Data still to be written */
+	u32 ByteCount;		/**< Number of bytes still to be written */
+	XTime LastProgress;	/**< Time of the last accepted page */
+} EepromWriteJob;
+
+/*
+ * The completion flags of the transfers on one driver instance. Handler()
+ * gets them as the callback reference of the instance, and the functions
+ * that wait for a transfer are passed the flags of the instance they use.
+ */
+typedef struct {
+	XIicPs *IicPtr;			/**< Driver instance of the flags */
+	volatile u8 TransmitComplete;	/**< Transmission completed */
+	volatile u8 ReceiveComplete;	/**< Reception completed */
+	volatile u32 TotalErrorCount;	/**< Errors of the transfer in flight */
+	volatile u32 SlaveResponse;	/**< Slave monitor saw an ACK */
+} IicPsFlags;
+
+/*
+ * A PS IIC controller used by the concurrent example. Each controller has its
+ * own driver instance, buffer and completion flags, so transfers
+ * on all of them can be in flight at the same time.
+ */
+typedef struct {
+	XIicPs Instance;	/**< Driver instance of the controller */
+	u16 DeviceId;		/**< Device ID of the controller */
+	u32 IntrId;		/**< Interrupt ID of the controller */
+	u32 IsPresent;		/**< An EEPROM was found on the controller */
+	EepromDevice Eeprom;	/**< The EEPROM on the controller */
+	EepromWriteJob Job;	/**< Transfer to or from the EEPROM */
+	u32 ChunkSize;		/**< Bytes in the transfer in flight */
+	u16 BlockSlvAddr;	/**< Slave address of the block addressed */
+	u8 WriteBuffer[sizeof(AddressType) + MAX_SIZE];
+	u8 SearchState;		/**< IIC_SEARCH_* state of the EEPROM search */
+	u8 SearchMux;		/**< Index of the mux in MuxAddr[] */
+	u8 SearchIndex;		/**< Index of the address in EepromAddr[] */
+	u8 SearchChannel;	/**< Channel searched alone */
+	u8 ProbeActive;		/**< The slave monitor is running */
+	int SearchStatus;	/**< XST_FAILURE if a mux could not be set */
+	XTime ProbeStart;	/**< Start of the running probe */
+	XTime SearchTime;	/**< Duration of the search */
+	IicPsFlags Flags;	/**< Completion flags of the controller */
+} IicPsController;
+
+typedef struct EepromRequest EepromRequest;
+
+/*
+ * Completion callback of a request, called from interrupt context.
+ */
+typedef void (*EepromRequestCallback)(EepromRequest *Req);
+
+/*
+ * A read or write queued with EepromSubmit(). The caller owns the memory of
+ * the request and the data buffer until the callback has been called.
+ */
+struct EepromRequest {
+	XIicPs *IicPtr;		/**< Instance the request runs on */
+	u32 Type;		/**< EEPROM_REQ_READ or EEPROM_REQ_WRITE */
+	u16 Address;		/**< Word address of the first byte */
+	u8 *BufferPtr;		/**< Data to write or buffer to read into */
+	u32 ByteCount;		/**< Number of bytes to transfer */
+	EepromRequestCallback Callback;	/**< Called on completion, or NULL */
+	void *CallBackRef;	/**< Passed on to the callback unchanged */
+	volatile int Status;	/**< XST_DEVICE_BUSY until completed */
+	XTime SubmitTime;	/**< Time the request was queued */
+	u32 Offset;		/**< Bytes transferred so far */
+	u32 ChunkSize;		/**< Bytes of the transfer in flight */
+	u32 Phase;		/**< EEPROM_PHASE_* of the transfer in flight */
+};
+
+/*
+ * Observable state of the request queue.
+ */
+typedef struct {
+	u32 Depth;		/**< Requests queued, including the active one */
+	u32 MaxDepth;		/**< Largest depth seen */
+	u32 InFlight;		/**< Requests with a transfer on the bus */
+	u32 Submitted;		/**< Requests accepted */
+	u32 Completed;		/**< Requests completed successfully */
+	u32 Failed;		/**< Requests completed with an error */
+	XTime LatencyLast;	/**< Submit to completion of the last request */
+	XTime LatencyMax;	/**< Worst submit to completion latency */
+	XTime LatencyTotal;	/**< Sum of all completion latencies */
+} EepromQueueStats;
+
+/*
+ * Latency histogram of one kind of transaction.
+ */
+typedef struct {
+	u32 Count;		/**< Transactions recorded */
+	XTime Total;		/**< Sum of their latencies */
+	XTime Max;		/**< Worst latency */
+	u32 Buckets[IIC_STATS_BUCKETS];	/**< Counts per latency range */
+} IicPsLatencyHist;
+
+/*
+ * Bus counters and the latency histograms of the IIC_STATS_* transactions.
+ */
+typedef struct {
+	IicPsLatencyHist Latency[IIC_STATS_KINDS];
+	u32 BytesSent;		/**< Bytes written, address bytes included */
+	u32 BytesReceived;	/**< Bytes read */
+	u32 Nacks;		/**< Transfers, probes and write waits timed out */
+	u32 ArbLost;		/**< Transfers that lost the arbitration */
+	u32 Errors;		/**< Error events, NACKs included */
+} IicPsStats;
+
 /***************** Macros (Inline Functions) Definitions *********************/
 
+#define US_TO_COUNTS(Us)	((XTime)(Us) * (COUNTS_PER_SECOND / 1000000U))
+#define COUNTS_TO_US(Counts)	((Counts) / (COUNTS_PER_SECOND / 1000000U))
+
+/*
+ * Bytes of the EEPROM under test the cache holds.
+ */
+#define EEPROM_CACHE_BYTES	((EepromSize < EEPROM_CACHE_SIZE) ? \
+				 EepromSize : EEPROM_CACHE_SIZE)
+
+/*
+ * Interrupt ID of a controller, with the same mapping as IicPsFindDevice().
+ */
+#define IIC_INTR_ID(DeviceId)	(((DeviceId) == 0U) ? XPAR_XIICPS_1_INTR : \
+						      XPAR_XIICPS_0_INTR)
+
 /************************** Function Prototypes ******************************/
 
 int IicPsEepromIntrExample(void);
-static int EepromWriteData(XIicPs *IicInstance, u16 ByteCount);
-static int EepromReadData(XIicPs *IicInstance, u8 *BufferPtr, u16 ByteCount, u16 location_addr);
+static int EepromWriteData(XIicPs *IicInstance, IicPsFlags *Flags, u16 ByteCount);
+static int EepromReadData(XIicPs *IicInstance, IicPsFlags *Flags, u8 *BufferPtr, u16 ByteCount, u16 location_addr);
+static int EepromWaitWriteCycle(XIicPs *IicInstance, IicPsFlags *Flags);
+static int EepromSendData(XIicPs *IicInstance, IicPsFlags *Flags, u16 ByteCount);
+static int EepromPipelineWrite(XIicPs *IicInstance, IicPsFlags *Flags, EepromWriteJob *Jobs, u32 NumJobs);
+static int EepromPipelineExample(XIicPs *IicInstance, IicPsFlags *Flags);
+int EepromSubmit(XIicPs *IicInstance, EepromRequest *Req);
+static void EepromQueueStep(EepromRequest *Req);
+static void EepromQueueHandler(u32 Event);
+static void EepromQueueComplete(int Status);
+static void EepromQueueDone(EepromRequest *Req);
+static void EepromQueueAbort(void);
+static void EepromQueueCheckDeadline(void);
+static void IicPsWaitEvent(void);
+static XTime IicPsWaitEventUntil(XTime Deadline);
+static u32 IicPsTimerStart(XTime Now, XTime Deadline);
+static void IicPsTimerStop(void);
+#ifdef TTC_DEVICE_ID
+static int IicPsTimerInit(void);
+static void TimerHandler(void *CallBackRef);
+#endif
+static void IicPsWaitBusIdle(XIicPs *IicPtr);
+static int EepromQueueExample(XIicPs *IicInstance, IicPsFlags *Flags);
+static int IicPsControllerInit(IicPsController *Ctrl, u16 DeviceId);
+static int IicPsControllerGetGeometry(IicPsController *Ctrl);
+static int IicPsDiscover(IicPsController *Ctrls, u32 NumCtrls);
+static void IicPsDiscoverStep(IicPsController *Ctrl, u32 Acked);
+static int IicPsConcurrentWrite(IicPsController *Ctrls, u32 NumCtrls);
+static int IicPsConcurrentWaitWriteCycle(IicPsController *Ctrls, u32 NumCtrls);
+static int IicPsConcurrentRead(IicPsController *Ctrls, u32 NumCtrls);
+static int IicPsConcurrentExample(void);
+static int EepromWrite(XIicPs *IicInstance, IicPsFlags *Flags, u16 Address, u8 *BufferPtr, u32 ByteCount);
+static int EepromReadSequential(XIicPs *IicInstance, IicPsFlags *Flags, u8 *BufferPtr, u32 ByteCount, u16 Address);
+static u32 EepromDeviceFillAddress(const EepromDevice *Device, u8 *BufferPtr,
+				   u16 Address, u16 *BlockSlvAddr);
+static u32 EepromFillAddress(u8 *BufferPtr, u16 Address);
+static u32 EepromMatches(XIicPs *IicInstance, IicPsFlags *Flags, u16 Address, u8 *BufferPtr, u32 ByteCount);
+static void EepromRecordReadLatency(XTime StartTime);
+static void IicPsStatsRecord(u32 Kind, XTime StartTime);
+static void IicPsStatsAdd(u32 Kind, XTime Latency);
+static void IicPsStatsBytes(u32 IsRead, u32 ByteCount);
+static void IicPsStatsEvent(u32 Event);
+static void EepromQueueRecord(u32 Kind);
+static void EepromQueueUpdateCache(EepromRequest *Req);
+void IicPsStatsReset(void);
+void IicPsStatsDump(void);
+static int EepromCacheLoad(XIicPs *IicInstance, IicPsFlags *Flags);
+static int EepromCacheRead(XIicPs *IicInstance, IicPsFlags *Flags, u16 Address, u8 *BufferPtr, u32 ByteCount);
+static int EepromCacheWrite(XIicPs *IicInstance, IicPsFlags *Flags, u16 Address, u8 *BufferPtr, u32 ByteCount);
+static int EepromCachePoll(XIicPs *IicInstance, IicPsFlags *Flags);
+static int EepromCacheFlush(XIicPs *IicInstance, IicPsFlags *Flags);
 static void Handler(void *CallBackRef, u32 Event);
-static int IicPsSlaveMonitor(u16 Address, u16 DeviceId, u32 Int_Id);
+static int IicPsSlaveMonitor(u16 Address, u16 DeviceId);
 static int SetupInterruptSystem(XIicPs *IicPsPtr, u32 Int_Id);
-static int MuxInitChannel(u16 MuxIicAddr, u8 WriteBuffer);
-static int FindEepromDevice(u16 Address);
+static int MuxInitChannel(XIicPs *IicPtr, IicPsFlags *Flags, u16 MuxIicAddr, u8 WriteBuffer);
+static IicPsMuxState *MuxGetState(XIicPs *IicPtr, u16 MuxIicAddr);
+static IicPsMuxNode *MuxGetNode(u16 MuxIicAddr);
+static int MuxRoute(XIicPs *IicPtr, IicPsFlags *Flags, u16 MuxIicAddr, u8 Channel);
+static int FindEepromDevice(XIicPs *IicPtr, IicPsFlags *Flags, u16 Address);
+static int IicPsProbe(XIicPs *IicPtr, IicPsFlags *Flags, u16 Address, u32 TimeoutUs);
 static int IicPsFindEeprom(u16 *Eeprom_Addr, u32 *PageSize);
+static int IicPsLocateEeprom(u16 *Eeprom_Addr, u32 *PageSize);
+static int IicPsEnumerate(void);
+static int IicPsEnumerateSegment(u16 DeviceId, u16 MuxIicAddr, u8 MuxChannel, u32 *SkipMap);
+static void IicPsEnumerateSkipMap(u16 DeviceId, u16 MuxIicAddr, u32 *SkipMap);
+static u32 IicPsIsMux(IicPsDeviceEntry *Entry);
+static int IicPsSelectDevice(IicPsDeviceEntry *Entry);
+static int IicPsEnumerateExample(void);
+static void IicPsMonitorSetHandler(void *CallBackRef, IicPsMonitorHandler FuncPtr);
+static int IicPsMonitorStart(void);
+static void IicPsMonitorStop(void);
+static int IicPsMonitorPoll(void);
+static void IicPsMonitorAdd(u16 DeviceId, u16 MuxIicAddr, u8 MuxChannel, u16 Addr);
+static IicPsFlags *IicPsMonitorInstance(u16 DeviceId);
+static void IicPsMonitorReport(void *CallBackRef, IicPsDeviceEntry *Entry, u32 Event);
+static int IicPsMonitorExample(void);
+static u32 EepromTopologyChecksum(EepromTopology *TopologyPtr);
+u32 EepromTopologyLoad(void *BufferPtr, u32 ByteCount);
+void EepromTopologySave(const void *BufferPtr, u32 ByteCount);
 static int IicPsConfig(u16 DeviceId, u32 Int_Id);
+static int IicPsSessionOpen(u16 DeviceId);
+static void IicPsSessionClose(void);
 static int IicPsFindDevice(u16 addr, u16 DeviceId);
-static int FindEepromPageSize(u16 EepromAddr, u32 *PageSize_ptr);
+static int FindEepromPageSize(XIicPs *IicPtr, IicPsFlags *Flags, EepromDevice *Device);
+static int FindEepromAddrWidth(XIicPs *IicPtr, IicPsFlags *Flags, EepromDevice *Device);
+static int EepromGetGeometry(XIicPs *IicPtr, IicPsFlags *Flags, u16 DeviceId, EepromDevice *Device);
+#ifdef EEPROM_BENCHMARK
+int IicPsEepromBenchmark(void);
+static u32 BenchRandom(u32 Range);
+static void BenchRecord(XTime StartTime);
+static void BenchReport(const char *Workload, u32 ByteCount, XTime Elapsed);
+static int BenchDiscovery(u32 IsCold);
+#endif
 /************************** Variable Definitions *****************************/
 #ifndef TESTAPP_GEN
 XIicPs IicInstance;		/* The instance of the IIC device. */
 XScuGic InterruptController;	/* The instance of the Interrupt Controller. */
 #endif
+#ifdef TTC_DEVICE_ID
+XTtcPs TtcInstance;		/* The instance of the wakeup timer. */
+#endif
+u32 TimerReady;			/**< Wakeup timer is set up */
 u32 Platform;
 
 /*
@@ -129,17 +648,191 @@ u8 WriteBuffer[sizeof(AddressType) + MAX_SIZE];
 
 u8 ReadBuffer[MAX_SIZE];	/* Read buffer for reading a page. */
 
-volatile u8 TransmitComplete;	/**< Flag to check completion of Transmission */
-volatile u8 ReceiveComplete;	/**< Flag to check completion of Reception */
-volatile u32 TotalErrorCount;	/**< Total Error Count Flag */
-volatile u32 SlaveResponse;		/**< Slave Response Flag */
+u8 VerifyBuffer[256 * MAX_SIZE];	/* Buffer for the whole test area. */
+
+IicPsFlags IicFlags;		/**< Completion flags of IicInstance */
+
+/*
+ * Driver events seen by the status handlers, and the count the last wait
+ * in IicPsWaitEvent() returned at.
+ */
+volatile u32 IicEventCount;
+u32 IicEventsSeen;
+
+/*
+ * Time the waits of this example spent asleep in WFI and spinning on the
+ * bus busy state or the slave monitor.
+ */
+XTime CpuIdleTime;
+XTime CpuBusyTime;
 
 /**Searching for the required EEPROM Address and user can also add
  * their own EEPROM Address in the below array list**/
 u16 EepromAddr[] = {0x54,0x55,0};
-u16 MuxAddr[] = {0x74,0};
+u16 MuxAddr[] = {0x74,
+#ifdef IIC_MUX_CASCADE
+		 0x75,
+#endif
+		 0};
+
+/*
+ * Muxes behind a channel of another mux. A mux follows the one it is behind
+ * in MuxAddr[], and the mux addresses are unique on each bus.
+ */
+IicPsMuxNode MuxTree[] = {
+#ifdef IIC_MUX_CASCADE
+	{0x75, 0x74, 0x02},
+#endif
+	{0, 0, 0}
+};
+
+/*
+ * Timeout of the probes done during the EEPROM search, and the number and
+ * total duration of all probes.
+ */
+u32 ProbeTimeoutUs = SLV_MON_TIMEOUT_US;
+u32 ProbeCount;
+XTime ProbeTime;
+
+/*
+ * Default storage of the topology, in RAM that the start-up code does not
+ * clear, so that it survives a software reset.
+ */
+EepromTopology SavedTopology __attribute__((section(".noinit")));
+
+/*
+ * Device table built by IicPsEnumerate(), with the cost of the last scan.
+ */
+IicPsDeviceEntry DeviceTable[IIC_DEVICE_TABLE_SIZE];
+u32 DeviceTableCount;
+u32 EnumProbeCount;		/**< Probes of the last enumeration */
+XTime EnumTime;			/**< Duration of the last enumeration */
+XTime DiscoverTime;		/**< Duration of the last EEPROM search */
+
+/*
+ * Hot-plug monitor, see IicPsMonitorPoll().
+ */
+u32 MonitorEnabled;
+u32 MonitorIndex;		/**< Entry of DeviceTable probed next */
+XTime MonitorNext;		/**< Earliest start of the next probe */
+u32 MonitorPeriodUs = IIC_MONITOR_PERIOD_US;
+u32 MonitorDutyPermille = IIC_MONITOR_DUTY_PERMILLE;
+u32 MonitorProbeCount;		/**< Probes done by the monitor */
+u32 MonitorEventCount;		/**< Attach and detach callbacks */
+XTime MonitorBusTime;		/**< Bus time taken by the monitor */
+IicPsMonitorHandler MonitorHandler;
+void *MonitorCallBackRef;
+u16 ActiveDeviceId = IIC_NO_SESSION; /**< Controller of IicInstance */
+u32 ConfigCount;		/**< Controller set ups by IicPsConfig() */
+XTime ConfigTime;		/**< Time spent in them */
+u32 IntcReady;			/**< Interrupt controller is set up */
+
+/*
+ * Geometries already detected, see EepromGetGeometry().
+ */
+EepromGeometryEntry GeometryCache[EEPROM_GEOMETRY_CACHE_SIZE];
+u32 GeometryCacheCount;
+u32 GeometryDetectCount;	/**< Detections that wrote to an EEPROM */
+
+/*
+ * Mux channel tracking, see MuxInitChannel().
+ */
+IicPsMuxState MuxStates[IIC_MUX_STATE_SIZE];
+u32 MuxVerifySelect = MUX_VERIFY_SELECT;
+u32 MuxSwitchCount;		/**< Channel selects written to a mux */
+u32 MuxSkipCount;		/**< Selects skipped, channel already set */
+
+/*
+ * Routes opened with MuxRoute(), the last one on each controller and the
+ * mux selects they took.
+ */
+IicPsMuxRoute MuxRoutes[XPAR_XIICPS_NUM_INSTANCES];
+u32 MuxRouteCount;
+u32 MuxRouteWrites;		/**< Selects written by all routes */
+u32 MuxLastRouteWrites;		/**< Selects written by the last route */
 u16 EepromSlvAddr;
 u32 PageSize;
+
+/*
+ * Geometry of the EEPROM under test. EepromFillAddress() sets
+ * EepromBlockSlvAddr to the slave address of the 256 byte block the word
+ * address falls in, which the transfer that follows is addressed to.
+ */
+u32 EepromAddrBytes = 2;
+u8 EepromBlockMask;
+u32 EepromSize = EEPROM_DEFAULT_SIZE;
+u16 EepromBlockSlvAddr;
+u16 EepromDeviceId;		/**< Controller the EEPROM is on */
+u16 EepromMuxAddr;		/**< Mux in front of the EEPROM, 0 if none */
+u8 EepromMuxChannel;		/**< Mux channel of the EEPROM */
+
+/*
+ * Write cycle completion mode and the upper bound of the ACK polling.
+ */
+u32 WriteWaitMode = EEPROM_WRITE_WAIT_MODE;
+u32 WriteTimeoutUs = EEPROM_WRITE_TIMEOUT_US;
+
+/*
+ * SCL rate the controllers are set up with.
+ */
+u32 SClkRate = IIC_SCLK_RATE;
+
+u32 CompareBeforeWrite = EEPROM_COMPARE_BEFORE_WRITE;
+u32 PageWriteCount;		/**< Page writes issued by EepromWrite() */
+u32 PageSkipCount;		/**< Unchanged page writes skipped */
+u32 PipelineBusyCount;		/**< Pipelined writes refused during tWR */
+
+IicPsController IicControllers[XPAR_XIICPS_NUM_INSTANCES];
+
+/*
+ * Ring of pending requests, the head is the active one. QueueBuffer holds
+ * the word address and the page of the transfer in flight.
+ */
+EepromRequest *RequestQueue[EEPROM_QUEUE_DEPTH];
+u32 QueueHead;
+u8 QueueBuffer[sizeof(AddressType) + MAX_SIZE];
+volatile EepromQueueStats QueueStats;
+XTime QueuePhaseStart;		/**< Start of the phase of the active request */
+XTime QueueDeadline;		/**< End of the write cycle wait of the active request */
+
+/*
+ * RAM shadow of the EEPROM and the bitmap of pages not yet written back.
+ */
+u8 EepromCache[EEPROM_CACHE_SIZE];
+u32 CacheDirtyMap[EEPROM_CACHE_MAX_PAGES / 32];
+u32 CacheDirtyCount;		/**< Number of dirty pages */
+u32 CacheValid;			/**< Shadow holds the EEPROM contents */
+XTime CacheDirtySince;		/**< Time of the oldest pending update */
+u32 CacheDirtyLimit = EEPROM_CACHE_DIRTY_LIMIT;
+u32 CacheFlushUs = EEPROM_CACHE_FLUSH_US;
+
+/*
+ * Latency of EepromReadData(), from the address phase to the last byte read.
+ */
+u32 ReadCount;			/**< Number of reads */
+XTime ReadLatencyLast;		/**< Latency of the last read */
+XTime ReadLatencyMax;		/**< Worst read latency */
+XTime ReadLatencyTotal;		/**< Sum of all read latencies */
+
+/*
+ * Transaction statistics, see IicPsStatsDump(). The status handlers update
+ * them as well.
+ */
+volatile IicPsStats Stats;
+const char *StatsNames[IIC_STATS_KINDS] = {
+	"send", "recv", "address", "write wait", "mux", "probe"
+};
+#ifdef EEPROM_BENCHMARK
+/*
+ * SCL rates the benchmark runs at, 0 terminated, and the latencies of the
+ * operations of the workload being run.
+ */
+u32 BenchSClkRates[] = {100000, 400000, 1000000, 0};
+XTime BenchLatency[BENCH_MAX_OPS];
+u32 BenchOps;			/**< Operations timed in BenchLatency[] */
+u32 BenchSeed = 1;		/**< State of BenchRandom() */
+#endif
+
 /************************** Function Definitions *****************************/
 
 /*****************************************************************************/
@@ -163,7 +856,11 @@ int main(void)
 	/*
 	 * Run the Iic EEPROM interrupt mode example.
 	 */
+#ifdef EEPROM_BENCHMARK
+	Status = IicPsEepromBenchmark();
+#else
 	Status = IicPsEepromIntrExample();
+#endif
 	if (Status != XST_SUCCESS) {
 		xil_printf("IIC EEPROM Interrupt Example Test Failed\r\n");
 		return XST_FAILURE;
@@ -190,63 +887,164 @@ int IicPsEepromIntrExample()
 {
 	u32 Index;
 	int Status;
-	AddressType Address = EEPROM_START_ADDRESS;
-	int WrBfrOffset;
+	XTime StartTime, EndTime;
+	u32 PageWrites;
+	u32 TestSize = 0;
+	u8 Record[2];
 
 
-	Status = IicPsFindEeprom(&EepromSlvAddr,&PageSize);
+	IicPsStatsReset();
+	XTime_GetTime(&StartTime);
+	Status = IicPsLocateEeprom(&EepromSlvAddr,&PageSize);
+	if (Status == XST_SUCCESS) {
+		/*
+		 * The test area is the whole EEPROM, as far as VerifyBuffer
+		 * holds it.
+		 */
+		TestSize = (EepromSize < sizeof(VerifyBuffer)) ? EepromSize :
+			   sizeof(VerifyBuffer);
+	}
 	if (Status != XST_SUCCESS) {
 		return XST_FAILURE;
 	}
+	XTime_GetTime(&EndTime);
+	xil_printf("Found the EEPROM in %d us, %d probes taking %d us\r\n",
+		   (u32)COUNTS_TO_US(EndTime - StartTime), ProbeCount,
+		   (u32)COUNTS_TO_US(ProbeTime));
+	xil_printf("%d controller set ups taking %d us\r\n", ConfigCount,
+		   (u32)COUNTS_TO_US(ConfigTime));
 
-	for(int page_count = 0; page_count < 256; page_count++)
-	{
 	/*
-	 * Initialize the data to write and the read buffer.
+	 * Initialize the data to write, page n of the test area holds n.
 	 */
-	if (PageSize == PAGE_SIZE_16) {
-		WriteBuffer[0] = (u8) (Address);
-		WrBfrOffset = 1;
-	} else {
-		WriteBuffer[0] = (u8) ((page_count * PageSize)>> 8) & 0xFF;
-		WriteBuffer[1] = (u8) (page_count * PageSize) & 0xFF;
-		WrBfrOffset = 2;
+	for (Index = 0; Index < TestSize; Index++) {
+		VerifyBuffer[Index] = (u8)(Index / PageSize);
+	}
+
+	/*
+	 * Write to the EEPROM, EepromWrite() splits the data into page writes.
+	 */
+	XTime_GetTime(&StartTime);
+	Status = EepromWrite(&IicInstance, &IicFlags, EEPROM_START_ADDRESS,
+			     VerifyBuffer, TestSize);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
 	}
+	XTime_GetTime(&EndTime);
+	xil_printf("Wrote %d pages, skipped %d unchanged pages in %d ms\r\n",
+		   PageWriteCount, PageSkipCount,
+		   (u32)(COUNTS_TO_US(EndTime - StartTime) / 1000U));
 
-	for (Index = 0; Index < PageSize; Index++) {
-		WriteBuffer[WrBfrOffset + Index] = page_count;
-		ReadBuffer[Index] = 0;
+	for (Index = 0; Index < TestSize; Index++) {
+		VerifyBuffer[Index] = 0;
 	}
 
 	/*
-	 * Write to the EEPROM.
+	 * Read the whole area back in one bus session.
 	 */
-	Status = EepromWriteData(&IicInstance, WrBfrOffset + PageSize);
+	XTime_GetTime(&StartTime);
+	Status = EepromReadSequential(&IicInstance, &IicFlags, VerifyBuffer,
+				      TestSize, EEPROM_START_ADDRESS);
 	if (Status != XST_SUCCESS) {
 		return XST_FAILURE;
 	}
+	XTime_GetTime(&EndTime);
+
+	/*
+	 * Verify the data read against the data written.
+	 */
+	for (Index = 0; Index < TestSize; Index++) {
+		if (VerifyBuffer[Index] != (u8)(Index / PageSize)) {
+			return XST_FAILURE;
+		}
+	}
+
+	xil_printf("Read %d bytes in %d us, %d bytes/s\r\n", TestSize,
+		   (u32)COUNTS_TO_US(EndTime - StartTime),
+		   (EndTime == StartTime) ? 0U : (u32)((u64)TestSize *
+		   COUNTS_PER_SECOND / (EndTime - StartTime)));
+
+	xil_printf("Read latency: %d reads, avg %d us, max %d us\r\n",
+		   ReadCount,
+		   (ReadCount == 0U) ? 0U :
+		   (u32)COUNTS_TO_US(ReadLatencyTotal / ReadCount),
+		   (u32)COUNTS_TO_US(ReadLatencyMax));
+
+	/*
+	 * Update a small record repeatedly through the cache. The reads are
+	 * served from RAM and the updates are written back to the EEPROM with
+	 * a single page write.
+	 */
+	Status = EepromCacheLoad(&IicInstance, &IicFlags);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
 	}
 
-	for(int page_count = 0; page_count < 256; page_count++)
-		{
-			/*
-			 * Read from the EEPROM.
-			 */
-			Status = EepromReadData(&IicInstance, ReadBuffer, PageSize, page_count * PageSize);
-			if (Status != XST_SUCCESS) {
-				return XST_FAILURE;
-			}
+	PageWrites = PageWriteCount;
+	for (Index = 0; Index < 32; Index++) {
+		Status = EepromCacheRead(&IicInstance, &IicFlags,
+					 EEPROM_START_ADDRESS, Record,
+					 sizeof(Record));
+		if (Status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
 
-			/*
-			* Verify the data read against the data written.
-			*/
-			for (Index = 0; Index < PageSize; Index++) {
-			if (ReadBuffer[Index] != page_count) {
-				return XST_FAILURE;
-			}
-			}
+		Record[0]++;
+		Record[1] = (u8)~Record[0];
+		Status = EepromCacheWrite(&IicInstance, &IicFlags,
+					  EEPROM_START_ADDRESS, Record,
+					  sizeof(Record));
+		if (Status != XST_SUCCESS) {
+			return XST_FAILURE;
 		}
+	}
+
+	Status = EepromCacheFlush(&IicInstance, &IicFlags);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	xil_printf("Cache: 32 record updates, %d page writes\r\n",
+		   PageWriteCount - PageWrites);
+
+	Status = EepromReadData(&IicInstance, &IicFlags, ReadBuffer,
+				sizeof(Record), EEPROM_START_ADDRESS);
+	if ((Status != XST_SUCCESS) || (ReadBuffer[0] != Record[0]) ||
+	    (ReadBuffer[1] != Record[1])) {
+		return XST_FAILURE;
+	}
 
+	Status = EepromQueueExample(&IicInstance, &IicFlags);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	Status = EepromPipelineExample(&IicInstance, &IicFlags);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	Status = IicPsConcurrentExample();
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	Status = IicPsEnumerateExample();
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	Status = IicPsMonitorExample();
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	xil_printf("CPU: %d us asleep in WFI, %d us busy waiting\r\n",
+		   (u32)COUNTS_TO_US(CpuIdleTime), (u32)COUNTS_TO_US(CpuBusyTime));
+
+	/*
+	 * Print the bus counters and the latency histograms of the run.
+	 */
+	IicPsStatsDump();
 
 	return XST_SUCCESS;
 }
@@ -261,506 +1059,4598 @@ int IicPsEepromIntrExample()
 * @return	XST_SUCCESS if successful else XST_FAILURE.
 *
 * @note		The Byte count should not exceed the page size of the EEPROM as
-*		noted by the constant PAGE_SIZE.
+*		noted by the constant PAGE_SIZE. The function returns once the
+*		EEPROM has finished programming, see EepromWaitWriteCycle().
 *
 ******************************************************************************/
-static int EepromWriteData(XIicPs *IicInstance, u16 ByteCount)
+static int EepromWriteData(XIicPs *IicInstance, IicPsFlags *Flags, u16 ByteCount)
 {
-
-	TransmitComplete = FALSE;
+	int Status;
 
 	/*
 	 * Send the Data.
 	 */
-	XIicPs_MasterSend(IicInstance, WriteBuffer,
-			   ByteCount, EepromSlvAddr);
+	Status = EepromSendData(IicInstance, Flags, ByteCount);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
 
 	/*
-	 * Wait for the entire buffer to be sent, letting the interrupt
-	 * processing work in the background, this function may get
-	 * locked up in this loop if the interrupts are not working
-	 * correctly.
-	 */
-	while (TransmitComplete == FALSE) {
-		if (0 != TotalErrorCount) {
-			return XST_FAILURE;
-		}
-	}
-
-	/*
-	 * Wait until bus is idle to start another transfer.
+	 * Wait for the programming to complete.
 	 */
-	while (XIicPs_BusIsBusy(IicInstance));
-
-	/*
-	 * Wait for a bit of time to allow the programming to complete
-	 */
-	usleep(250000);
-
-	return XST_SUCCESS;
+	return EepromWaitWriteCycle(IicInstance, Flags);
 }
 
 /*****************************************************************************/
 /**
-* This function reads data from the IIC serial EEPROM into a specified buffer.
+* This function sends the write buffer to the EEPROM without waiting for the
+* write cycle that follows.
 *
-* @param	BufferPtr contains the address of the data buffer to be filled.
-* @param	ByteCount contains the number of bytes in the buffer to be read.
+* @param	ByteCount contains the number of bytes in the buffer to be
+*		sent.
 *
-* @return	XST_SUCCESS if successful else XST_FAILURE.
+* @return	XST_SUCCESS if successful else XST_FAILURE, which includes
+*		the EEPROM not acknowledging because it is still programming.
 *
 * @note		None.
 *
 ******************************************************************************/
-static int EepromReadData(XIicPs *IicInstance, u8 *BufferPtr, u16 ByteCount, u16 Address)
+static int EepromSendData(XIicPs *IicInstance, IicPsFlags *Flags, u16 ByteCount)
 {
-	int Status;
-	//AddressType Address = EEPROM_START_ADDRESS;
-	int WrBfrOffset;
+	XTime StartTime;
+
+	Flags->TransmitComplete = FALSE;
+	Flags->TotalErrorCount = 0;
+	XTime_GetTime(&StartTime);
 
 	/*
-	 * Position the Pointer in EEPROM.
+	 * Send the Data.
 	 */
-	if (PageSize == PAGE_SIZE_16) {
-		WriteBuffer[0] = (u8) (Address);
-		WrBfrOffset = 1;
-	} else {
-		WriteBuffer[0] = (u8) (Address >> 8);
-		WriteBuffer[1] = (u8) (Address);
-		WrBfrOffset = 2;
-	}
-
-	Status = EepromWriteData(IicInstance, WrBfrOffset);
-	if (Status != XST_SUCCESS) {
-		return XST_FAILURE;
-	}
-
-	ReceiveComplete = FALSE;
+	XIicPs_MasterSend(IicInstance, WriteBuffer,
+			   ByteCount, EepromBlockSlvAddr);
 
 	/*
-	 * Receive the Data.
+	 * Wait for the entire buffer to be sent, letting the interrupt
+	 * processing work in the background, this function may get
+	 * locked up in this loop if the interrupts are not working
+	 * correctly.
 	 */
-	XIicPs_MasterRecv(IicInstance, BufferPtr,
-			   ByteCount, EepromSlvAddr);
-
-	while (ReceiveComplete == FALSE) {
-		if (0 != TotalErrorCount) {
+	while (Flags->TransmitComplete == FALSE) {
+		if (0 != Flags->TotalErrorCount) {
 			return XST_FAILURE;
 		}
+		IicPsWaitEvent();
 	}
 
 	/*
 	 * Wait until bus is idle to start another transfer.
 	 */
-	while (XIicPs_BusIsBusy(IicInstance));
+	IicPsWaitBusIdle(IicInstance);
+	IicPsStatsBytes(FALSE, ByteCount);
+	IicPsStatsRecord(IIC_STATS_SEND, StartTime);
 
 	return XST_SUCCESS;
 }
 
-/******************************************************************************/
+/*****************************************************************************/
 /**
+* This function writes an area of any offset and length to the IIC serial
+* EEPROM.
 *
-* This function setups the interrupt system such that interrupts can occur
-* for the IIC.
+* The data is split at the page boundaries of the EEPROM so that every page
+* write stays within one page and the area is programmed with the minimum
+* number of write cycles. Partial first and last pages are written with only
+* the bytes that fall into them.
 *
-* @param	IicPsPtr contains a pointer to the instance of the Iic
-*		which is going to be connected to the interrupt controller.
+* @param	Address is the word address of the first byte to write.
+* @param	BufferPtr contains the data to write.
+* @param	ByteCount contains the number of bytes to write.
 *
-* @return	XST_SUCCESS if successful, otherwise XST_FAILURE.
+* @return	XST_SUCCESS if successful else XST_FAILURE.
 *
-* @note		None.
+* @note		The page writes are counted in PageWriteCount, and the ones
+*		skipped by CompareBeforeWrite in PageSkipCount. The cache is
+*		updated with the data written when it is loaded.
 *
-*******************************************************************************/
-static int SetupInterruptSystem(XIicPs *IicPsPtr, u32 Int_Id)
+******************************************************************************/
+static int EepromWrite(XIicPs *IicInstance, IicPsFlags *Flags, u16 Address, u8 *BufferPtr, u32 ByteCount)
 {
 	int Status;
-	XScuGic_Config *IntcConfig; /* Instance of the interrupt controller */
-
-	Xil_ExceptionInit();
+	u32 WrBfrOffset;
+	u32 ChunkSize;
+	u32 Index;
 
-	/*
-	 * Initialize the interrupt controller driver so that it is ready to
-	 * use.
-	 */
-	IntcConfig = XScuGic_LookupConfig(INTC_DEVICE_ID);
-	if (NULL == IntcConfig) {
-		return XST_FAILURE;
-	}
+	while (ByteCount > 0U) {
+		/*
+		 * Write up to the end of the page the address falls in.
+		 */
+		ChunkSize = PageSize - (Address % PageSize);
+		if (ChunkSize > ByteCount) {
+			ChunkSize = ByteCount;
+		}
 
-	Status = XScuGic_CfgInitialize(&InterruptController, IntcConfig,
-					IntcConfig->CpuBaseAddress);
-	if (Status != XST_SUCCESS) {
-		return XST_FAILURE;
-	}
+		if ((CompareBeforeWrite != FALSE) &&
+		    (EepromMatches(IicInstance, Flags, Address, BufferPtr,
+				   ChunkSize) != FALSE)) {
+			PageSkipCount++;
+		} else {
+			WrBfrOffset = EepromFillAddress(WriteBuffer, Address);
+			for (Index = 0; Index < ChunkSize; Index++) {
+				WriteBuffer[WrBfrOffset + Index] =
+					BufferPtr[Index];
+			}
 
+			Status = EepromWriteData(IicInstance, Flags,
+						 WrBfrOffset + ChunkSize);
+			if (Status != XST_SUCCESS) {
+				return XST_FAILURE;
+			}
+			PageWriteCount++;
+		}
 
-	/*
-	 * Connect the interrupt controller interrupt handler to the hardware
-	 * interrupt handling logic in the processor.
-	 */
-	Xil_ExceptionRegisterHandler(XIL_EXCEPTION_ID_IRQ_INT,
-				(Xil_ExceptionHandler)XScuGic_InterruptHandler,
-				&InterruptController);
+		/*
+		 * Keep the cache coherent with the EEPROM.
+		 */
+		if ((CacheValid != FALSE) &&
+		    ((u32)Address + ChunkSize <= EEPROM_CACHE_BYTES)) {
+			for (Index = 0; Index < ChunkSize; Index++) {
+				EepromCache[Address + Index] = BufferPtr[Index];
+			}
+		}
 
-	/*
-	 * Connect the device driver handler that will be called when an
-	 * interrupt for the device occurs, the handler defined above performs
-	 * the specific interrupt processing for the device.
-	 */
-	Status = XScuGic_Connect(&InterruptController, Int_Id,
-			(Xil_InterruptHandler)XIicPs_MasterInterruptHandler,
-			(void *)IicPsPtr);
-	if (Status != XST_SUCCESS) {
-		return Status;
+		Address += ChunkSize;
+		BufferPtr += ChunkSize;
+		ByteCount -= ChunkSize;
 	}
 
-	/*
-	 * Enable the interrupt for the Iic device.
-	 */
-	XScuGic_Enable(&InterruptController, Int_Id);
-
-
-	/*
-	 * Enable interrupts in the Processor.
-	 */
-	Xil_ExceptionEnable();
-
 	return XST_SUCCESS;
 }
 
 /*****************************************************************************/
 /**
+* This function waits for the internal write cycle of the EEPROM to finish.
 *
-* This function is the handler which performs processing to handle data events
-* from the IIC.  It is called from an interrupt context such that the amount
-* of processing performed should be minimized.
-*
-* This handler provides an example of how to handle data for the IIC and
-* is application specific.
+* In EEPROM_WAIT_ACK_POLL mode the slave monitor keeps addressing the EEPROM,
+* which does not acknowledge while it is programming, and the slave ready
+* interrupt ends the wait as soon as the EEPROM responds. In
+* EEPROM_WAIT_FIXED_DELAY mode it sleeps for the worst case write cycle time
+* instead.
 *
-* @param	CallBackRef contains a callback reference from the driver, in
-*		this case it is the instance pointer for the IIC driver.
-* @param	Event contains the specific kind of event that has occurred.
-* @param	EventData contains the number of bytes sent or received for sent
-*		and receive events.
+* @param	IicInstance is a pointer to the IIC driver instance.
 *
-* @return	None.
+* @return	XST_SUCCESS if the EEPROM is ready, XST_FAILURE if it did not
+*		respond within WriteTimeoutUs.
 *
-* @note		None.
+* @note		An address-only write does not start a write cycle, so the
+*		EEPROM acknowledges the first poll in that case.
 *
-*******************************************************************************/
-void Handler(void *CallBackRef, u32 Event)
+******************************************************************************/
+static int EepromWaitWriteCycle(XIicPs *IicInstance, IicPsFlags *Flags)
 {
+	XTime StartTime, Now, Deadline;
+
+	XTime_GetTime(&StartTime);
+	if (WriteWaitMode == EEPROM_WAIT_FIXED_DELAY) {
+		usleep(EEPROM_WRITE_DELAY_US);
+		IicPsStatsRecord(IIC_STATS_WRITE_WAIT, StartTime);
+		return XST_SUCCESS;
+	}
+
+	Flags->SlaveResponse = FALSE;
+	Deadline = StartTime + US_TO_COUNTS(WriteTimeoutUs);
+	XIicPs_DisableAllInterrupts(IicInstance->Config.BaseAddress);
+	XIicPs_EnableSlaveMonitor(IicInstance, EepromSlvAddr);
+
 	/*
-	 * All of the data transfer has been finished.
+	 * The slave monitor does not raise NACK interrupts, the handler only
+	 * reports the slave ready event. The wakeup timer ends the sleep if
+	 * the EEPROM never responds. The polls the EEPROM refused are not
+	 * seen, only the timeout counts as a NACK.
 	 */
+	XTime_GetTime(&Now);
+	while ((Flags->SlaveResponse == FALSE) && (Now < Deadline)) {
+		Now = IicPsWaitEventUntil(Deadline);
+	}
 
-	if (0 != (Event & XIICPS_EVENT_COMPLETE_SEND)) {
-		TransmitComplete = TRUE;
-	} else if (0 != (Event & XIICPS_EVENT_COMPLETE_RECV)){
-		ReceiveComplete = TRUE;
-	} else if (0 != (Event & XIICPS_EVENT_SLAVE_RDY)) {
-		SlaveResponse = TRUE;
-	} else if (0 != (Event & XIICPS_EVENT_ERROR)){
-		TotalErrorCount++;
+	XIicPs_DisableSlaveMonitor(IicInstance);
+	IicPsStatsAdd(IIC_STATS_WRITE_WAIT, Now - StartTime);
+	if (Flags->SlaveResponse == FALSE) {
+		Stats.Nacks++;
+		return XST_FAILURE;
 	}
+	return XST_SUCCESS;
 }
 
 /*****************************************************************************/
 /**
-* This function initializes the IIC MUX to select the required channel.
+* This function reads data from the IIC serial EEPROM into a specified buffer.
 *
-* @param	MuxAddress and Channel select value.
+* The word address and the read are sent as one combined transaction: the
+* address is written with the bus held and the data is read after a repeated
+* start, so the access needs neither a STOP nor a write cycle wait between
+* the two phases. The latency of every read is recorded in ReadCount,
+* ReadLatencyLast, ReadLatencyMax and ReadLatencyTotal.
 *
-* @return	XST_SUCCESS if pass, otherwise XST_FAILURE.
+* @param	BufferPtr contains the address of the data buffer to be filled.
+* @param	ByteCount contains the number of bytes in the buffer to be read.
+* @param	Address is the word address of the first byte to read.
+*
+* @return	XST_SUCCESS if successful else XST_FAILURE.
 *
 * @note		None.
 *
-****************************************************************************/
-static int MuxInitChannel(u16 MuxIicAddr, u8 WriteBuffer)
+******************************************************************************/
+static int EepromReadData(XIicPs *IicInstance, IicPsFlags *Flags, u8 *BufferPtr, u16 ByteCount, u16 Address)
 {
-	u8 Buffer = 0;
+	int WrBfrOffset;
+	XTime StartTime, RecvTime;
 
-	TotalErrorCount = 0;
-	TransmitComplete = FALSE;
-	TotalErrorCount = 0;
+	XTime_GetTime(&StartTime);
 
-	XIicPs_MasterSend(&IicInstance, &WriteBuffer,1,MuxIicAddr);
-	while (TransmitComplete == FALSE) {
-		if (0 != TotalErrorCount) {
+	/*
+	 * Position the Pointer in EEPROM.
+	 */
+	WrBfrOffset = EepromFillAddress(WriteBuffer, Address);
+
+	/*
+	 * Send the address with the bus held so that the read follows with a
+	 * repeated start. Without a STOP the EEPROM does not start a write
+	 * cycle, so there is nothing to wait for in between.
+	 */
+	XIicPs_SetOptions(IicInstance, XIICPS_REP_START_OPTION);
+	Flags->TransmitComplete = FALSE;
+	XIicPs_MasterSend(IicInstance, WriteBuffer, WrBfrOffset, EepromBlockSlvAddr);
+
+	while (Flags->TransmitComplete == FALSE) {
+		if (0 != Flags->TotalErrorCount) {
+			XIicPs_ClearOptions(IicInstance, XIICPS_REP_START_OPTION);
 			return XST_FAILURE;
 		}
+		IicPsWaitEvent();
 	}
-	/*
-	 * Wait until bus is idle to start another transfer.
-	 */
+	XIicPs_ClearOptions(IicInstance, XIICPS_REP_START_OPTION);
+	IicPsStatsBytes(FALSE, WrBfrOffset);
+	XTime_GetTime(&RecvTime);
+	IicPsStatsAdd(IIC_STATS_ADDRESS, RecvTime - StartTime);
 
-	while (XIicPs_BusIsBusy(&IicInstance));
+	Flags->ReceiveComplete = FALSE;
 
-	ReceiveComplete = FALSE;
 	/*
-	 * Receive the Data.
+	 * Receive the Data, the STOP follows the last byte.
 	 */
-	XIicPs_MasterRecv(&IicInstance, &Buffer,1, MuxIicAddr);
+	XIicPs_MasterRecv(IicInstance, BufferPtr,
+			   ByteCount, EepromBlockSlvAddr);
 
-	while (ReceiveComplete == FALSE) {
-		if (0 != TotalErrorCount) {
+	while (Flags->ReceiveComplete == FALSE) {
+		if (0 != Flags->TotalErrorCount) {
 			return XST_FAILURE;
 		}
+		IicPsWaitEvent();
 	}
+
 	/*
 	 * Wait until bus is idle to start another transfer.
 	 */
-	while (XIicPs_BusIsBusy(&IicInstance));
+	IicPsWaitBusIdle(IicInstance);
+	IicPsStatsBytes(TRUE, ByteCount);
+	IicPsStatsRecord(IIC_STATS_RECV, RecvTime);
+
+	EepromRecordReadLatency(StartTime);
 
 	return XST_SUCCESS;
 }
+
 /*****************************************************************************/
 /**
-* This function perform the initial configuration for the IICPS Device.
+* This function reads a contiguous area of the IIC serial EEPROM in a single
+* bus session.
 *
-* @param	DeviceId instance and Interrupt ID mapped to the device.
+* The word address is sent once, then the data is streamed with consecutive
+* reads of at most XIICPS_MAX_TRANSFER_SIZE bytes. The bus is held from the
+* address phase to the last byte, so no other master can get in between and
+* the EEPROM keeps incrementing its internal address counter across the
+* reads.
 *
-* @return	XST_SUCCESS if pass, otherwise XST_FAILURE.
+* @param	BufferPtr contains the address of the data buffer to be filled.
+* @param	ByteCount contains the number of bytes to read.
+* @param	Address is the word address of the first byte to read.
 *
-* @note		None.
+* @return	XST_SUCCESS if successful else XST_FAILURE.
 *
-****************************************************************************/
-static int IicPsConfig(u16 DeviceId, u32 Int_Id)
+* @note		The internal address counter rolls over at the end of the
+*		array, so reads past the end continue from address 0. The
+*		latency is not recorded in ReadCount and ReadLatency*, which
+*		are kept for the page reads of EepromReadData().
+*
+******************************************************************************/
+static int EepromReadSequential(XIicPs *IicInstance, IicPsFlags *Flags, u8 *BufferPtr, u32 ByteCount, u16 Address)
 {
-	int Status;
-	XIicPs_Config *ConfigPtr;	/* Pointer to configuration data */
+	int WrBfrOffset;
+	u32 ChunkSize;
+	XTime StartTime, RecvTime;
+
+	XTime_GetTime(&StartTime);
 
 	/*
-	 * Initialize the IIC driver so that it is ready to use.
+	 * Position the Pointer in EEPROM.
 	 */
-	ConfigPtr = XIicPs_LookupConfig(DeviceId);
-	if (ConfigPtr == NULL) {
-		return XST_FAILURE;
-	}
+	WrBfrOffset = EepromFillAddress(WriteBuffer, Address);
 
-	Status = XIicPs_CfgInitialize(&IicInstance, ConfigPtr,
-					ConfigPtr->BaseAddress);
-	if (Status != XST_SUCCESS) {
-		return XST_FAILURE;
+	XIicPs_SetOptions(IicInstance, XIICPS_REP_START_OPTION);
+	Flags->TransmitComplete = FALSE;
+	XIicPs_MasterSend(IicInstance, WriteBuffer, WrBfrOffset, EepromBlockSlvAddr);
+
+	while (Flags->TransmitComplete == FALSE) {
+		if (0 != Flags->TotalErrorCount) {
+			XIicPs_ClearOptions(IicInstance, XIICPS_REP_START_OPTION);
+			return XST_FAILURE;
+		}
+		IicPsWaitEvent();
 	}
+	IicPsStatsBytes(FALSE, WrBfrOffset);
+	IicPsStatsRecord(IIC_STATS_ADDRESS, StartTime);
 
 	/*
-	 * Setup the Interrupt System.
+	 * Stream the data, each chunk continues at the internal address
+	 * counter of the EEPROM. The STOP follows the last chunk only.
 	 */
-	Status = SetupInterruptSystem(&IicInstance, Int_Id);
-	if (Status != XST_SUCCESS) {
-		return XST_FAILURE;
+	while (ByteCount > 0U) {
+		ChunkSize = ByteCount;
+		if (ChunkSize > XIICPS_MAX_TRANSFER_SIZE) {
+			ChunkSize = XIICPS_MAX_TRANSFER_SIZE;
+		} else {
+			XIicPs_ClearOptions(IicInstance, XIICPS_REP_START_OPTION);
+		}
+
+		Flags->ReceiveComplete = FALSE;
+		XTime_GetTime(&RecvTime);
+		XIicPs_MasterRecv(IicInstance, BufferPtr, ChunkSize,
+				  EepromBlockSlvAddr);
+
+		while (Flags->ReceiveComplete == FALSE) {
+			if (0 != Flags->TotalErrorCount) {
+				XIicPs_ClearOptions(IicInstance,
+						    XIICPS_REP_START_OPTION);
+				return XST_FAILURE;
+			}
+			IicPsWaitEvent();
+		}
+		IicPsStatsBytes(TRUE, ChunkSize);
+		IicPsStatsRecord(IIC_STATS_RECV, RecvTime);
+		BufferPtr += ChunkSize;
+		ByteCount -= ChunkSize;
 	}
 
 	/*
-	 * Setup the handlers for the IIC that will be called from the
-	 * interrupt context when data has been sent and received, specify a
-	 * pointer to the IIC driver instance as the callback reference so
-	 * the handlers are able to access the instance data.
+	 * Wait until bus is idle to start another transfer.
 	 */
-	XIicPs_SetStatusHandler(&IicInstance, (void *) &IicInstance, Handler);
+	IicPsWaitBusIdle(IicInstance);
 
-	/*
-	 * Set the IIC serial clock rate.
-	 */
-	XIicPs_SetSClk(&IicInstance, IIC_SCLK_RATE);
 	return XST_SUCCESS;
 }
 
-static int IicPsFindDevice(u16 addr, u16 DeviceId)
-{
-	int Status;
-
-	if (DeviceId == 0){
-		Status = IicPsSlaveMonitor(addr,DeviceId,XPAR_XIICPS_1_INTR);
-		if (Status == XST_SUCCESS) {
-			return XST_SUCCESS;
-		}
-	}
-	else if (DeviceId == 1) {
-		Status = IicPsSlaveMonitor(addr,DeviceId,XPAR_XIICPS_0_INTR);
-		if (Status == XST_SUCCESS) {
-			return XST_SUCCESS;
-		}
-	}
-	return XST_FAILURE;
-}
 /*****************************************************************************/
 /**
-* This function is use to figure out the Eeprom slave device
+* This function writes the word address of an EEPROM to the start of a
+* buffer, using the AddrBytes address bytes of the EEPROM.
 *
-* @param	Eeprom slave address
+* @param	Device is the EEPROM.
+* @param	BufferPtr is the buffer to write the address to.
+* @param	Address is the word address.
+* @param	BlockSlvAddr returns the slave address to send the buffer to.
 *
-* @param	Pagesize pointer
+* @return	The number of address bytes written.
 *
-* @return	XST_SUCCESS if successful and also update the epprom slave
-* device address in addr variable else XST_FAILURE.
-*
-* @note		None.
+* @note		The bits of the address above the address bytes go to the
+*		block select bits of the slave address.
 *
 ******************************************************************************/
-static int IicPsFindEeprom(u16 *Eeprom_Addr,u32 *PageSize)
+static u32 EepromDeviceFillAddress(const EepromDevice *Device, u8 *BufferPtr,
+				   u16 Address, u16 *BlockSlvAddr)
 {
-	int Status;
-	u16 DeviceId;
-	int MuxIndex,Index;
-	u8 MuxChannel;
-
-	for (DeviceId = 0; DeviceId < XPAR_XIICPS_NUM_INSTANCES; DeviceId++) {
-		for(MuxIndex=0;MuxAddr[MuxIndex] != 0;MuxIndex++){
-			Status = IicPsFindDevice(MuxAddr[MuxIndex], DeviceId);
-			if (Status == XST_SUCCESS) {
-				for(Index=0;EepromAddr[Index] != 0;Index++) {
-					for(MuxChannel = 0x01; MuxChannel <= MAX_CHANNELS; MuxChannel = MuxChannel << 1) {
-						Status = MuxInitChannel(MuxAddr[MuxIndex], MuxChannel);
-						if (Status != XST_SUCCESS) {
-							xil_printf("Failed to enable the MUX channel\r\n");
-							return XST_FAILURE;
-						}
-						Status = FindEepromDevice(EepromAddr[Index]);
-						FindEepromDevice(MUX_ADDR);
-						if (Status == XST_SUCCESS) {
-							*Eeprom_Addr = EepromAddr[Index];
-						Status = FindEepromPageSize(EepromAddr[Index], PageSize);
-						if (Status != XST_SUCCESS) {
-							xil_printf("Failed to find the page size of 0X%X EEPROM\r\n", EepromAddr[Index]);
-							return XST_FAILURE;
-						}
-						xil_printf("Page size %d\r\n", *PageSize);
-						return XST_SUCCESS;
-						}
-					}
-				}
-			}
-		}
-		for(Index=0;EepromAddr[Index] != 0;Index++) {
-			Status = IicPsFindDevice(EepromAddr[Index], DeviceId);
-			if (Status == XST_SUCCESS) {
-				*Eeprom_Addr = EepromAddr[Index];
-				*PageSize = PAGE_SIZE_32;
-				return XST_SUCCESS;
-			}
-		}
+	if (Device->AddrBytes == 1U) {
+		*BlockSlvAddr = Device->SlvAddr |
+				((Address >> 8) & Device->BlockMask);
+		BufferPtr[0] = (u8) (Address);
+		return 1;
 	}
-	return XST_FAILURE;
-}
-static int FindEepromDevice(u16 Address)
-{
-	int Index;
-	XIicPs *IicPtr = &IicInstance;
-	SlaveResponse = FALSE;
-
-	XIicPs_DisableAllInterrupts(IicPtr->Config.BaseAddress);
-	XIicPs_EnableSlaveMonitor(&IicInstance, Address);
-
-		TotalErrorCount = 0;
-
-		Index = 0;
-
-		/*
-		 * Wait for the Slave Monitor Interrupt, the interrupt processing
-		 * works in the background, this function may get locked up in this
-		 * loop if the interrupts are not working correctly or the slave
-		 * never responds.
-		 */
-		while ((!SlaveResponse) && (Index < SLV_MON_LOOP_COUNT)) {
-			Index++;
-
-			/*
-			 * Ignore any errors. The hardware generates NACK interrupts
-			 * if the slave is not present.
-			 */
-			if (0 != TotalErrorCount) {
-				xil_printf("Test error unexpected NACK\n");
-			}
-		}
-
-		if (Index >= SLV_MON_LOOP_COUNT) {
-			XIicPs_DisableSlaveMonitor(&IicInstance);
-			return XST_FAILURE;
-
-		}
 
-		XIicPs_DisableSlaveMonitor(&IicInstance);
-		return XST_SUCCESS;
+	*BlockSlvAddr = Device->SlvAddr;
+	BufferPtr[0] = (u8) (Address >> 8);
+	BufferPtr[1] = (u8) (Address);
+	return 2;
 }
 
 /*****************************************************************************/
 /**
-* This function is used to figure out page size Eeprom slave device
-*
-* @param	Eeprom Address
+* This function writes the word address of the EEPROM under test to the start
+* of a buffer, using EepromAddrBytes address bytes.
 *
-* @param	Pagesize pointer
+* @param	BufferPtr is the buffer to write the address to.
+* @param	Address is the word address.
 *
-* @return	XST_SUCCESS if successful and also update the epprom slave
-* device pagesize else XST_FAILURE.
+* @return	The number of address bytes written.
 *
-* @note		None.
+* @note		The slave address to send the buffer to is set in
+*		EepromBlockSlvAddr.
 *
 ******************************************************************************/
-static int FindEepromPageSize(u16 EepromAddr, u32 *PageSize_ptr)
+static u32 EepromFillAddress(u8 *BufferPtr, u16 Address)
 {
-	u32 Index, i;
-	int Status = XST_FAILURE;
-	AddressType Address = EEPROM_START_ADDRESS;
-	int WrBfrOffset = 0;
-	u32 ps[3] = {64, 32, 16};
-	u32 PageSize_test, count;
-
-	for (i = 0; i < 3; i++)
-	{
-		count = 0;
-		PageSize_test = ps[i];
-		*PageSize_ptr = PageSize_test;
-		/*
-		 * Initialize the data to write and the read buffer.
-		 */
-		if (PageSize_test == PAGE_SIZE_16) {
-			WriteBuffer[0] = (u8) (Address);
-			WrBfrOffset = 1;
-		} else {
-			WriteBuffer[0] = (u8) (Address >> 8);
-			WriteBuffer[1] = (u8) (Address);
-			WrBfrOffset = 2;
-		}
+	EepromDevice Device = {0};
 
-		for (Index = 0; Index < PageSize_test; Index++) {
-			WriteBuffer[WrBfrOffset + Index] = Index + i;
-			ReadBuffer[Index] = 0;
+	Device.SlvAddr = EepromSlvAddr;
+	Device.AddrBytes = EepromAddrBytes;
+	Device.BlockMask = EepromBlockMask;
+
+	return EepromDeviceFillAddress(&Device, BufferPtr, Address,
+				       &EepromBlockSlvAddr);
+}
+
+/*****************************************************************************/
+/**
+* This function checks whether an area of the EEPROM already holds the given
+* data. Clean pages of a loaded cache are compared in RAM, anything else is
+* read back from the EEPROM.
+*
+* @param	IicInstance is a pointer to the IIC driver instance.
+* @param	Address is the word address of the first byte to compare.
+* @param	BufferPtr contains the data to compare with.
+* @param	ByteCount is the number of bytes, at most one page.
+*
+* @return	TRUE if the contents match, FALSE if they differ or could not
+*		be read.
+*
+* @note		A dirty cache page holds data the EEPROM does not have yet, so
+*		it is never used for the comparison.
+*
+******************************************************************************/
+static u32 EepromMatches(XIicPs *IicInstance, IicPsFlags *Flags, u16 Address, u8 *BufferPtr, u32 ByteCount)
+{
+	u8 *ContentsPtr = ReadBuffer;
+	u32 Page = Address / PageSize;
+	u32 Index;
+
+	if ((CacheValid != FALSE) &&
+	    ((u32)Address + ByteCount <= EEPROM_CACHE_BYTES) &&
+	    ((CacheDirtyMap[Page / 32] & (1U << (Page % 32))) == 0U)) {
+		ContentsPtr = &EepromCache[Address];
+	} else if (EepromReadData(IicInstance, Flags, ReadBuffer, ByteCount,
+				  Address) != XST_SUCCESS) {
+		return FALSE;
+	}
+
+	for (Index = 0; Index < ByteCount; Index++) {
+		if (ContentsPtr[Index] != BufferPtr[Index]) {
+			return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+/*****************************************************************************/
+/**
+* This function records the latency of a completed read in ReadCount,
+* ReadLatencyLast, ReadLatencyMax and ReadLatencyTotal.
+*
+* @param	StartTime is the time the read was started at.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void EepromRecordReadLatency(XTime StartTime)
+{
+	XTime EndTime;
+
+	XTime_GetTime(&EndTime);
+	ReadLatencyLast = EndTime - StartTime;
+	ReadLatencyTotal += ReadLatencyLast;
+	if (ReadLatencyLast > ReadLatencyMax) {
+		ReadLatencyMax = ReadLatencyLast;
+	}
+	ReadCount++;
+}
+
+/*****************************************************************************/
+/**
+* This function records the latency of a transaction that has just ended in
+* the histogram of its kind.
+*
+* @param	Kind is the IIC_STATS_* kind of the transaction.
+* @param	StartTime is the time the transaction was started at.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void IicPsStatsRecord(u32 Kind, XTime StartTime)
+{
+	XTime EndTime;
+
+	XTime_GetTime(&EndTime);
+	IicPsStatsAdd(Kind, EndTime - StartTime);
+}
+
+/*****************************************************************************/
+/**
+* This function adds a latency to the histogram of a kind of transaction.
+*
+* @param	Kind is the IIC_STATS_* kind of the transaction.
+* @param	Latency is the duration of the transaction in timer counts.
+*
+* @return	None.
+*
+* @note		The time taken is bounded by IIC_STATS_BUCKETS and nothing is
+*		allocated, so this can be called from a handler. A kind is
+*		only recorded by the code that owns the bus, so the handler
+*		and the foreground never update one histogram at once.
+*
+******************************************************************************/
+static void IicPsStatsAdd(u32 Kind, XTime Latency)
+{
+	volatile IicPsLatencyHist *Hist = &Stats.Latency[Kind];
+	XTime Us = COUNTS_TO_US(Latency);
+	u32 Bucket = 0;
+
+	while ((Bucket < (IIC_STATS_BUCKETS - 1U)) &&
+	       (Us >= ((XTime)1U << Bucket))) {
+		Bucket++;
+	}
+
+	Hist->Buckets[Bucket]++;
+	Hist->Count++;
+	Hist->Total += Latency;
+	if (Latency > Hist->Max) {
+		Hist->Max = Latency;
+	}
+}
+
+/*****************************************************************************/
+/**
+* This function adds the bytes of a completed transfer to BytesSent or
+* BytesReceived. Failed transfers are counted by IicPsStatsEvent().
+*
+* @param	IsRead is TRUE for a receive, FALSE for a send.
+* @param	ByteCount is the number of bytes of the transfer.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void IicPsStatsBytes(u32 IsRead, u32 ByteCount)
+{
+	if (IsRead != FALSE) {
+		Stats.BytesReceived += ByteCount;
+	} else {
+		Stats.BytesSent += ByteCount;
+	}
+}
+
+/*****************************************************************************/
+/**
+* This function counts the error events of the driver in Errors, and the NACK
+* and arbitration lost events in Nacks and ArbLost.
+*
+* @param	Event contains the events passed to the status handler.
+*
+* @return	None.
+*
+* @note		Called from the status handlers in interrupt context, it only
+*		increments counters.
+*
+******************************************************************************/
+static void IicPsStatsEvent(u32 Event)
+{
+	if (0 != (Event & (XIICPS_EVENT_ERROR | XIICPS_EVENT_NACK |
+			   XIICPS_EVENT_ARB_LOST))) {
+		Stats.Errors++;
+	}
+	if (0 != (Event & XIICPS_EVENT_NACK)) {
+		Stats.Nacks++;
+	}
+	if (0 != (Event & XIICPS_EVENT_ARB_LOST)) {
+		Stats.ArbLost++;
+	}
+}
+
+/*****************************************************************************/
+/**
+* This function clears the bus counters and the latency histograms.
+*
+* @param	None.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+void IicPsStatsReset(void)
+{
+	volatile IicPsLatencyHist *Hist;
+	u32 Kind;
+	u32 Bucket;
+
+	for (Kind = 0; Kind < IIC_STATS_KINDS; Kind++) {
+		Hist = &Stats.Latency[Kind];
+		Hist->Count = 0;
+		Hist->Total = 0;
+		Hist->Max = 0;
+		for (Bucket = 0; Bucket < IIC_STATS_BUCKETS; Bucket++) {
+			Hist->Buckets[Bucket] = 0;
+		}
+	}
+
+	Stats.BytesSent = 0;
+	Stats.BytesReceived = 0;
+	Stats.Nacks = 0;
+	Stats.ArbLost = 0;
+	Stats.Errors = 0;
+}
+
+/*****************************************************************************/
+/**
+* This function prints the bus counters and, for every kind of transaction
+* seen since the last IicPsStatsReset(), its count, average and worst latency
+* and the buckets of its histogram that are not empty.
+*
+* @param	None.
+*
+* @return	None.
+*
+* @note		The statistics keep counting, the function can be called at
+*		any time.
+*
+******************************************************************************/
+void IicPsStatsDump(void)
+{
+	volatile IicPsLatencyHist *Hist;
+	u32 Kind;
+	u32 Bucket;
+
+	xil_printf("Bus: %d bytes sent, %d bytes received, %d errors, "
+		   "%d NACKs, %d arbitration lost\r\n", Stats.BytesSent,
+		   Stats.BytesReceived, Stats.Errors, Stats.Nacks,
+		   Stats.ArbLost);
+
+	for (Kind = 0; Kind < IIC_STATS_KINDS; Kind++) {
+		Hist = &Stats.Latency[Kind];
+		if (Hist->Count == 0U) {
+			continue;
+		}
+		xil_printf("%s: %d, avg %d us, max %d us\r\n",
+			   StatsNames[Kind], Hist->Count,
+			   (u32)COUNTS_TO_US(Hist->Total / Hist->Count),
+			   (u32)COUNTS_TO_US(Hist->Max));
+		for (Bucket = 0; Bucket < IIC_STATS_BUCKETS; Bucket++) {
+			if (Hist->Buckets[Bucket] == 0U) {
+				continue;
+			}
+			if (Bucket == (IIC_STATS_BUCKETS - 1U)) {
+				xil_printf("  >= %d us: %d\r\n",
+					   1U << (Bucket - 1U),
+					   Hist->Buckets[Bucket]);
+			} else {
+				xil_printf("  < %d us: %d\r\n", 1U << Bucket,
+					   Hist->Buckets[Bucket]);
+			}
+		}
+	}
+}
+
+/*****************************************************************************/
+/**
+* This function fills the RAM shadow of the EEPROM and discards any pending
+* updates.
+*
+* @param	IicInstance is a pointer to the IIC driver instance.
+*
+* @return	XST_SUCCESS if successful else XST_FAILURE.
+*
+* @note		None.
+*
+******************************************************************************/
+static int EepromCacheLoad(XIicPs *IicInstance, IicPsFlags *Flags)
+{
+	int Status;
+	u32 Index;
+
+	CacheValid = FALSE;
+	Status = EepromReadSequential(IicInstance, Flags, EepromCache,
+				      EEPROM_CACHE_BYTES, 0);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	for (Index = 0; Index < EEPROM_CACHE_MAX_PAGES / 32; Index++) {
+		CacheDirtyMap[Index] = 0;
+	}
+	CacheDirtyCount = 0;
+	CacheValid = TRUE;
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* This function reads from the RAM shadow of the EEPROM, loading it first if
+* it is not populated yet.
+*
+* @param	IicInstance is a pointer to the IIC driver instance.
+* @param	Address is the word address of the first byte to read.
+* @param	BufferPtr contains the address of the data buffer to be filled.
+* @param	ByteCount contains the number of bytes to read.
+*
+* @return	XST_SUCCESS if successful else XST_FAILURE.
+*
+* @note		Pending updates are returned, flushed or not.
+*
+******************************************************************************/
+static int EepromCacheRead(XIicPs *IicInstance, IicPsFlags *Flags, u16 Address, u8 *BufferPtr, u32 ByteCount)
+{
+	u32 Index;
+
+	if ((u32)Address + ByteCount > EEPROM_CACHE_BYTES) {
+		return XST_FAILURE;
+	}
+
+	if ((CacheValid == FALSE) &&
+	    (EepromCacheLoad(IicInstance, Flags) != XST_SUCCESS)) {
+		return XST_FAILURE;
+	}
+
+	for (Index = 0; Index < ByteCount; Index++) {
+		BufferPtr[Index] = EepromCache[Address + Index];
+	}
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* This function updates the RAM shadow of the EEPROM and marks the affected
+* pages dirty. The EEPROM itself is only written when the cache is flushed.
+*
+* @param	IicInstance is a pointer to the IIC driver instance.
+* @param	Address is the word address of the first byte to write.
+* @param	BufferPtr contains the data to write.
+* @param	ByteCount contains the number of bytes to write.
+*
+* @return	XST_SUCCESS if successful else XST_FAILURE.
+*
+* @note		EepromCachePoll() is called after the update, so the dirty
+*		page limit and the flush timer are checked on every write.
+*
+******************************************************************************/
+static int EepromCacheWrite(XIicPs *IicInstance, IicPsFlags *Flags, u16 Address, u8 *BufferPtr, u32 ByteCount)
+{
+	u32 Index;
+	u32 Page;
+
+	if ((u32)Address + ByteCount > EEPROM_CACHE_BYTES) {
+		return XST_FAILURE;
+	}
+
+	if ((CacheValid == FALSE) &&
+	    (EepromCacheLoad(IicInstance, Flags) != XST_SUCCESS)) {
+		return XST_FAILURE;
+	}
+
+	for (Index = 0; Index < ByteCount; Index++) {
+		EepromCache[Address + Index] = BufferPtr[Index];
+
+		Page = (Address + Index) / PageSize;
+		if ((CacheDirtyMap[Page / 32] & (1U << (Page % 32))) == 0U) {
+			CacheDirtyMap[Page / 32] |= 1U << (Page % 32);
+			if (CacheDirtyCount++ == 0U) {
+				XTime_GetTime(&CacheDirtySince);
+			}
+		}
+	}
+
+	return EepromCachePoll(IicInstance, Flags);
+}
+
+/*****************************************************************************/
+/**
+* This function flushes the cache when the number of dirty pages reaches
+* CacheDirtyLimit or the oldest pending update is older than CacheFlushUs.
+* It is meant to be called periodically, e.g. from a timer tick or the main
+* loop, so that pending updates reach the EEPROM in bounded time.
+*
+* @param	IicInstance is a pointer to the IIC driver instance.
+*
+* @return	XST_SUCCESS if successful else XST_FAILURE.
+*
+* @note		None.
+*
+******************************************************************************/
+static int EepromCachePoll(XIicPs *IicInstance, IicPsFlags *Flags)
+{
+	XTime Now;
+
+	if (CacheDirtyCount == 0U) {
+		return XST_SUCCESS;
+	}
+
+	XTime_GetTime(&Now);
+	if ((CacheDirtyCount >= CacheDirtyLimit) ||
+	    ((Now - CacheDirtySince) >= US_TO_COUNTS(CacheFlushUs))) {
+		return EepromCacheFlush(IicInstance, Flags);
+	}
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* This function writes every dirty page of the cache back to the EEPROM, one
+* write cycle per page however often the page was updated.
+*
+* @param	IicInstance is a pointer to the IIC driver instance.
+*
+* @return	XST_SUCCESS if successful else XST_FAILURE.
+*
+* @note		A page that fails to write stays dirty.
+*
+******************************************************************************/
+static int EepromCacheFlush(XIicPs *IicInstance, IicPsFlags *Flags)
+{
+	int Status;
+	u32 Page;
+
+	for (Page = 0; (CacheDirtyCount > 0U) &&
+	     (Page < EEPROM_CACHE_BYTES / PageSize); Page++) {
+		if ((CacheDirtyMap[Page / 32] & (1U << (Page % 32))) == 0U) {
+			continue;
+		}
+
+		Status = EepromWrite(IicInstance, Flags, Page * PageSize,
+				     &EepromCache[Page * PageSize], PageSize);
+		if (Status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+
+		CacheDirtyMap[Page / 32] &= ~(1U << (Page % 32));
+		CacheDirtyCount--;
+	}
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* This function writes to several EEPROMs at once, overlapping their internal
+* write cycles.
+*
+* The jobs are served round robin one page at a time: while one EEPROM is
+* programming the page it just received, the bus is used to send a page to
+* the next one. An EEPROM that is still busy does not acknowledge its
+* address, in which case its job is skipped for this round. The aggregate
+* throughput therefore scales with the number of EEPROMs until the bus
+* itself is saturated.
+*
+* @param	IicInstance is a pointer to the IIC driver instance.
+* @param	Jobs is the array of writes, one per EEPROM.
+* @param	NumJobs is the number of entries in Jobs.
+*
+* @return	XST_SUCCESS if all the data was written, XST_FAILURE if an
+*		EEPROM did not accept a page within WriteTimeoutUs.
+*
+* @note		When all EEPROMs sit behind the same mux at distinct addresses
+*		their channels are opened together, so switching between them
+*		costs no mux traffic. The pages are written as they are, without
+*		compare-before-write, and the cache is invalidated. The mux
+*		route and the geometry of the EEPROM under test are restored
+*		on return, also on failure.
+*
+******************************************************************************/
+static int EepromPipelineWrite(XIicPs *IicInstance, IicPsFlags *Flags, EepromWriteJob *Jobs, u32 NumJobs)
+{
+	int Status = XST_SUCCESS;
+	EepromWriteJob *Job;
+	EepromDevice *Current = NULL;
+	u16 SavedSlvAddr = EepromSlvAddr;
+	u32 SavedPageSize = PageSize;
+	u32 SavedAddrBytes = EepromAddrBytes;
+	u8 SavedBlockMask = EepromBlockMask;
+	IicPsMuxRoute SavedRoute = MuxRoutes[IicInstance->Config.DeviceId];
+	u32 SharedMux = TRUE;
+	u8 ChannelMask = 0;
+	u32 WrBfrOffset;
+	u32 ChunkSize;
+	u32 Pending;
+	u32 Index, Other;
+	XTime Now;
+
+	CacheValid = FALSE;
+
+	XTime_GetTime(&Now);
+	for (Index = 0; Index < NumJobs; Index++) {
+		Jobs[Index].LastProgress = Now;
+		ChannelMask |= Jobs[Index].Device->MuxChannel;
+		if (Jobs[Index].Device->MuxAddr != Jobs[0].Device->MuxAddr) {
+			SharedMux = FALSE;
+		}
+		for (Other = 0; Other < Index; Other++) {
+			if (Jobs[Other].Device->SlvAddr ==
+			    Jobs[Index].Device->SlvAddr) {
+				SharedMux = FALSE;
+			}
+		}
+	}
+
+	if ((SharedMux != FALSE) && (Jobs[0].Device->MuxAddr != 0)) {
+		Status = MuxRoute(IicInstance, Flags, Jobs[0].Device->MuxAddr,
+				  ChannelMask);
+	}
+
+	do {
+		Pending = 0;
+		for (Index = 0; (Index < NumJobs) && (Status == XST_SUCCESS);
+		     Index++) {
+			Job = &Jobs[Index];
+			if (Job->ByteCount == 0U) {
+				continue;
+			}
+			Pending++;
+
+			if ((SharedMux == FALSE) && (Job->Device != Current) &&
+			    (Job->Device->MuxAddr != 0)) {
+				Status = MuxRoute(IicInstance, Flags,
+						  Job->Device->MuxAddr,
+						  Job->Device->MuxChannel);
+				if (Status != XST_SUCCESS) {
+					break;
+				}
+			}
+			Current = Job->Device;
+			EepromSlvAddr = Job->Device->SlvAddr;
+			PageSize = Job->Device->PageSize;
+			EepromAddrBytes = Job->Device->AddrBytes;
+			EepromBlockMask = Job->Device->BlockMask;
+
+			/*
+			 * Send the next page, up to the end of the page the
+			 * address falls in.
+			 */
+			ChunkSize = PageSize - (Job->Address % PageSize);
+			if (ChunkSize > Job->ByteCount) {
+				ChunkSize = Job->ByteCount;
+			}
+			WrBfrOffset = EepromFillAddress(WriteBuffer, Job->Address);
+			for (Other = 0; Other < ChunkSize; Other++) {
+				WriteBuffer[WrBfrOffset + Other] =
+					Job->BufferPtr[Other];
+			}
+
+			if (EepromSendData(IicInstance, Flags,
+					   WrBfrOffset + ChunkSize) != XST_SUCCESS) {
+				/*
+				 * Still programming the previous page.
+				 */
+				XTime_GetTime(&Now);
+				PipelineBusyCount++;
+				if ((Now - Job->LastProgress) >=
+				    US_TO_COUNTS(WriteTimeoutUs)) {
+					Status = XST_FAILURE;
+				}
+				continue;
+			}
+
+			XTime_GetTime(&Now);
+			Job->LastProgress = Now;
+			Job->Address += ChunkSize;
+			Job->BufferPtr += ChunkSize;
+			Job->ByteCount -= ChunkSize;
+			PageWriteCount++;
+		}
+	} while ((Pending > 0U) && (Status == XST_SUCCESS));
+
+	/*
+	 * Wait for the last write cycle of every EEPROM.
+	 */
+	for (Index = 0; (Index < NumJobs) && (Status == XST_SUCCESS); Index++) {
+		if ((SharedMux == FALSE) && (Jobs[Index].Device->MuxAddr != 0)) {
+			Status = MuxRoute(IicInstance, Flags,
+					  Jobs[Index].Device->MuxAddr,
+					  Jobs[Index].Device->MuxChannel);
+			if (Status != XST_SUCCESS) {
+				break;
+			}
+		}
+		EepromSlvAddr = Jobs[Index].Device->SlvAddr;
+		Status = EepromWaitWriteCycle(IicInstance, Flags);
+	}
+
+	/*
+	 * Whatever happened, give the EEPROM under test its geometry and the
+	 * bus its route back, closing the other channels of a shared mux.
+	 */
+	EepromSlvAddr = SavedSlvAddr;
+	PageSize = SavedPageSize;
+	EepromAddrBytes = SavedAddrBytes;
+	EepromBlockMask = SavedBlockMask;
+	if ((SavedRoute.MuxAddr != 0) &&
+	    (MuxRoute(IicInstance, Flags, SavedRoute.MuxAddr,
+		      SavedRoute.Channel) != XST_SUCCESS)) {
+		Status = XST_FAILURE;
+	}
+
+	return (Status == XST_SUCCESS) ? XST_SUCCESS : XST_FAILURE;
+}
+
+/*****************************************************************************/
+/**
+* This function writes EEPROM_PIPELINE_PAGES pages to every EEPROM found next
+* to the one under test with EepromPipelineWrite(), reports the aggregate
+* throughput and verifies the data.
+*
+* @param	IicInstance is a pointer to the IIC driver instance.
+*
+* @return	XST_SUCCESS if successful else XST_FAILURE.
+*
+* @note		The EEPROMs are looked for at the addresses in EepromAddr[] on
+*		the segment of the EEPROM under test, which is selected again
+*		on return.
+*
+******************************************************************************/
+static int EepromPipelineExample(XIicPs *IicInstance, IicPsFlags *Flags)
+{
+	EepromDevice Devices[EEPROM_MAX_DEVICES];
+	EepromWriteJob Jobs[EEPROM_MAX_DEVICES];
+	u32 ByteCount = EEPROM_PIPELINE_PAGES * PageSize;
+	u8 *ReadBackPtr = &VerifyBuffer[ByteCount];
+	u16 SavedSlvAddr = EepromSlvAddr;
+	u32 SavedPageSize = PageSize;
+	u32 SavedAddrBytes = EepromAddrBytes;
+	u8 SavedBlockMask = EepromBlockMask;
+	u32 NumDevices = 0;
+	u32 TotalBytes = 0;
+	u32 Length, Offset;
+	XTime StartTime, EndTime;
+	int Status;
+	u32 Index, Other;
+
+	/*
+	 * Collect the EEPROMs on the segment, the one under test first.
+	 */
+	for (Index = 0; (EepromAddr[Index] != 0) &&
+	     (NumDevices < EEPROM_MAX_DEVICES); Index++) {
+		/*
+		 * The block select addresses of an EEPROM already collected
+		 * are that EEPROM.
+		 */
+		for (Other = 0; Other < NumDevices; Other++) {
+			if ((EepromAddr[Index] & (u16)~Devices[Other].BlockMask) ==
+			    Devices[Other].SlvAddr) {
+				break;
+			}
+		}
+		if (Other < NumDevices) {
+			continue;
+		}
+
+		if ((EepromAddr[Index] != SavedSlvAddr) &&
+		    (FindEepromDevice(IicInstance, Flags, EepromAddr[Index]) !=
+		     XST_SUCCESS)) {
+			continue;
+		}
+
+		Devices[NumDevices].SlvAddr = EepromAddr[Index];
+		Devices[NumDevices].MuxAddr = EepromMuxAddr;
+		Devices[NumDevices].MuxChannel = EepromMuxChannel;
+		Devices[NumDevices].PageSize = SavedPageSize;
+		Devices[NumDevices].AddrBytes = (u8)EepromAddrBytes;
+		Devices[NumDevices].BlockMask = EepromBlockMask;
+		Devices[NumDevices].Size = EepromSize;
+		if (EepromAddr[Index] != SavedSlvAddr) {
+			EepromSlvAddr = EepromAddr[Index];
+			Status = EepromGetGeometry(IicInstance, Flags,
+						   EepromDeviceId,
+						   &Devices[NumDevices]);
+			EepromSlvAddr = SavedSlvAddr;
+			PageSize = SavedPageSize;
+			if (Status != XST_SUCCESS) {
+				continue;
+			}
+		}
+		NumDevices++;
+	}
+
+	for (Index = 0; Index < ByteCount; Index++) {
+		VerifyBuffer[Index] = (u8)(Index + 0x5A);
+	}
+	for (Index = 0; Index < NumDevices; Index++) {
+		Jobs[Index].Device = &Devices[Index];
+		Jobs[Index].Address = EEPROM_START_ADDRESS;
+		Jobs[Index].BufferPtr = VerifyBuffer;
+		Jobs[Index].ByteCount = EEPROM_PIPELINE_PAGES *
+					Devices[Index].PageSize;
+		if (Jobs[Index].ByteCount > ByteCount) {
+			Jobs[Index].ByteCount = ByteCount;
+		}
+		if (Jobs[Index].ByteCount > Devices[Index].Size) {
+			Jobs[Index].ByteCount = Devices[Index].Size;
+		}
+		TotalBytes += Jobs[Index].ByteCount;
+	}
+
+	XTime_GetTime(&StartTime);
+	Status = EepromPipelineWrite(IicInstance, Flags, Jobs, NumDevices);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	XTime_GetTime(&EndTime);
+
+	xil_printf("Pipelined %d bytes to %d EEPROMs in %d us, %d bytes/s\r\n",
+		   TotalBytes, NumDevices,
+		   (u32)COUNTS_TO_US(EndTime - StartTime),
+		   (EndTime == StartTime) ? 0U : (u32)((u64)TotalBytes *
+		   COUNTS_PER_SECOND / (EndTime - StartTime)));
+
+	/*
+	 * Verify the data written to every EEPROM.
+	 */
+	for (Index = 0; Index < NumDevices; Index++) {
+		EepromSlvAddr = Devices[Index].SlvAddr;
+		PageSize = Devices[Index].PageSize;
+		EepromAddrBytes = Devices[Index].AddrBytes;
+		EepromBlockMask = Devices[Index].BlockMask;
+		Length = EEPROM_PIPELINE_PAGES * PageSize;
+		if (Length > ByteCount) {
+			Length = ByteCount;
+		}
+		if (Length > Devices[Index].Size) {
+			Length = Devices[Index].Size;
+		}
+		Status = EepromReadSequential(IicInstance, Flags, ReadBackPtr,
+					      Length, EEPROM_START_ADDRESS);
+		if (Status != XST_SUCCESS) {
+			break;
+		}
+		for (Offset = 0; Offset < Length; Offset++) {
+			if (ReadBackPtr[Offset] != VerifyBuffer[Offset]) {
+				Status = XST_FAILURE;
+				break;
+			}
+		}
+		if (Status != XST_SUCCESS) {
+			break;
+		}
+	}
+
+	EepromSlvAddr = SavedSlvAddr;
+	PageSize = SavedPageSize;
+	EepromAddrBytes = SavedAddrBytes;
+	EepromBlockMask = SavedBlockMask;
+
+	return Status;
+}
+
+/*****************************************************************************/
+/**
+* This function queues a read or write of the EEPROM under test and returns
+* without waiting for it.
+*
+* The requests are served in order by Handler(), which starts the next
+* transfer from interrupt context when the previous one completes. A write
+* is split into page writes, each followed by polling the EEPROM with the
+* slave monitor until its write cycle ends, and a read into transfers of at
+* most XIICPS_MAX_TRANSFER_SIZE bytes with a repeated start after the word
+* address. When a request completes its Status is set and its callback is
+* called.
+*
+* @param	IicInstance is a pointer to the IIC driver instance.
+* @param	Req is the request, with Type, Address, BufferPtr, ByteCount,
+*		Callback and CallBackRef filled in.
+*
+* @return	XST_SUCCESS if the request was queued, XST_DEVICE_BUSY if
+*		EEPROM_QUEUE_DEPTH requests are pending already or
+*		XST_INVALID_PARAM for an empty request.
+*
+* @note		The blocking functions of this example must not be used on
+*		the same instance while requests are pending. The write cycle
+*		is always detected with the slave monitor, whatever
+*		WriteWaitMode is set to, and a request whose write cycle does
+*		not end within WriteTimeoutUs fails. The cache is updated as
+*		each page of a write is written, the bytes of a page
+*		EepromCacheWrite() changes while a write to it is pending are
+*		overwritten.
+*
+******************************************************************************/
+int EepromSubmit(XIicPs *IicInstance, EepromRequest *Req)
+{
+	u32 Tail;
+
+	if ((Req == NULL) || (Req->ByteCount == 0U)) {
+		return XST_INVALID_PARAM;
+	}
+
+	Req->IicPtr = IicInstance;
+	Req->Status = XST_DEVICE_BUSY;
+	Req->Offset = 0;
+	XTime_GetTime(&Req->SubmitTime);
+
+	/*
+	 * The queue is shared with the interrupt handler.
+	 */
+	Xil_ExceptionDisable();
+	if (QueueStats.Depth == EEPROM_QUEUE_DEPTH) {
+		Xil_ExceptionEnable();
+		return XST_DEVICE_BUSY;
+	}
+
+	Tail = (QueueHead + QueueStats.Depth) % EEPROM_QUEUE_DEPTH;
+	RequestQueue[Tail] = Req;
+	QueueStats.Depth++;
+	QueueStats.Submitted++;
+	if (QueueStats.Depth > QueueStats.MaxDepth) {
+		QueueStats.MaxDepth = QueueStats.Depth;
+	}
+
+	if (QueueStats.Depth == 1U) {
+		EepromQueueStep(Req);
+	}
+	Xil_ExceptionEnable();
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* This function starts the next transfer of the active request.
+*
+* @param	Req is the active request.
+*
+* @return	None.
+*
+* @note		Called from interrupt context or with the exceptions disabled.
+*
+******************************************************************************/
+static void EepromQueueStep(EepromRequest *Req)
+{
+	u16 Address = Req->Address + Req->Offset;
+	u32 WrBfrOffset;
+	u32 Index;
+
+	QueueStats.InFlight = 1;
+	XTime_GetTime(&QueuePhaseStart);
+	WrBfrOffset = EepromFillAddress(QueueBuffer, Address);
+
+	if (Req->Type == EEPROM_REQ_WRITE) {
+		Req->ChunkSize = PageSize - (Address % PageSize);
+		if (Req->ChunkSize > Req->ByteCount - Req->Offset) {
+			Req->ChunkSize = Req->ByteCount - Req->Offset;
+		}
+		for (Index = 0; Index < Req->ChunkSize; Index++) {
+			QueueBuffer[WrBfrOffset + Index] =
+				Req->BufferPtr[Req->Offset + Index];
+		}
+
+		Req->Phase = EEPROM_PHASE_DATA;
+		XIicPs_MasterSend(Req->IicPtr, QueueBuffer,
+				  WrBfrOffset + Req->ChunkSize, EepromBlockSlvAddr);
+	} else {
+		Req->ChunkSize = Req->ByteCount - Req->Offset;
+		if (Req->ChunkSize > XIICPS_MAX_TRANSFER_SIZE) {
+			Req->ChunkSize = XIICPS_MAX_TRANSFER_SIZE;
+		}
+
+		Req->Phase = EEPROM_PHASE_ADDRESS;
+		XIicPs_SetOptions(Req->IicPtr, XIICPS_REP_START_OPTION);
+		XIicPs_MasterSend(Req->IicPtr, QueueBuffer, WrBfrOffset,
+				  EepromBlockSlvAddr);
+	}
+}
+
+/*****************************************************************************/
+/**
+* This function advances the active request on an event of the driver.
+*
+* @param	Event contains the specific kind of event that has occurred.
+*
+* @return	None.
+*
+* @note		Called from Handler() in interrupt context.
+*
+******************************************************************************/
+static void EepromQueueHandler(u32 Event)
+{
+	EepromRequest *Req = RequestQueue[QueueHead];
+
+	if (0 != (Event & (XIICPS_EVENT_ERROR | XIICPS_EVENT_NACK |
+			   XIICPS_EVENT_ARB_LOST))) {
+		XIicPs_ClearOptions(Req->IicPtr, XIICPS_REP_START_OPTION);
+		EepromQueueComplete(XST_FAILURE);
+		return;
+	}
+
+	switch (Req->Phase) {
+	case EEPROM_PHASE_ADDRESS:
+		if (0 != (Event & XIICPS_EVENT_COMPLETE_SEND)) {
+			IicPsStatsBytes(FALSE, EepromAddrBytes);
+			EepromQueueRecord(IIC_STATS_ADDRESS);
+
+			/*
+			 * Read the data after the repeated start.
+			 */
+			XIicPs_ClearOptions(Req->IicPtr, XIICPS_REP_START_OPTION);
+			Req->Phase = EEPROM_PHASE_DATA;
+			XIicPs_MasterRecv(Req->IicPtr,
+					  &Req->BufferPtr[Req->Offset],
+					  Req->ChunkSize, EepromBlockSlvAddr);
+		}
+		break;
+
+	case EEPROM_PHASE_DATA:
+		if (0 != (Event & XIICPS_EVENT_COMPLETE_RECV)) {
+			IicPsStatsBytes(TRUE, Req->ChunkSize);
+			EepromQueueRecord(IIC_STATS_RECV);
+			Req->Offset += Req->ChunkSize;
+			if (Req->Offset == Req->ByteCount) {
+				EepromQueueComplete(XST_SUCCESS);
+			} else {
+				EepromQueueStep(Req);
+			}
+		} else if (0 != (Event & XIICPS_EVENT_COMPLETE_SEND)) {
+			/*
+			 * The page is sent, poll for the end of the write
+			 * cycle.
+			 */
+			IicPsStatsBytes(FALSE, EepromAddrBytes + Req->ChunkSize);
+			EepromQueueRecord(IIC_STATS_SEND);
+			Req->Phase = EEPROM_PHASE_WRITE_CYCLE;
+			QueueStats.InFlight = 0;
+			QueueDeadline = QueuePhaseStart +
+					US_TO_COUNTS(WriteTimeoutUs);
+			XIicPs_DisableAllInterrupts(
+				Req->IicPtr->Config.BaseAddress);
+			XIicPs_EnableSlaveMonitor(Req->IicPtr, EepromSlvAddr);
+			(void)IicPsTimerStart(QueuePhaseStart, QueueDeadline);
+		}
+		break;
+
+	case EEPROM_PHASE_WRITE_CYCLE:
+		if (0 != (Event & XIICPS_EVENT_SLAVE_RDY)) {
+			IicPsTimerStop();
+			XIicPs_DisableSlaveMonitor(Req->IicPtr);
+			EepromQueueRecord(IIC_STATS_WRITE_WAIT);
+			EepromQueueUpdateCache(Req);
+			Req->Offset += Req->ChunkSize;
+			if (Req->Offset == Req->ByteCount) {
+				EepromQueueComplete(XST_SUCCESS);
+			} else {
+				EepromQueueStep(Req);
+			}
+		}
+		break;
+
+	default:
+		break;
+	}
+}
+
+/*****************************************************************************/
+/**
+* This function records the phase of the active request that has just ended
+* in the histogram of its kind, and starts timing the next phase.
+*
+* @param	Kind is the IIC_STATS_* kind of the phase.
+*
+* @return	None.
+*
+* @note		Called from EepromQueueHandler() in interrupt context.
+*
+******************************************************************************/
+static void EepromQueueRecord(u32 Kind)
+{
+	XTime Now;
+
+	XTime_GetTime(&Now);
+	IicPsStatsAdd(Kind, Now - QueuePhaseStart);
+	QueuePhaseStart = Now;
+}
+
+/*****************************************************************************/
+/**
+* This function keeps the cache coherent with the page the active write
+* request has just written, as EepromWrite() does. A dirty page that the
+* write covered in full is clean again, the dirty bytes of a page it covered
+* in part are flushed later with the new data in place.
+*
+* @param	Req is the active request, at the end of the write cycle of
+*		the chunk at Offset.
+*
+* @return	None.
+*
+* @note		Called from EepromQueueHandler() in interrupt context.
+*
+******************************************************************************/
+static void EepromQueueUpdateCache(EepromRequest *Req)
+{
+	u16 Address = Req->Address + Req->Offset;
+	u32 Index;
+	u32 Page;
+
+	if ((CacheValid == FALSE) ||
+	    ((u32)Address + Req->ChunkSize > EEPROM_CACHE_BYTES)) {
+		return;
+	}
+
+	for (Index = 0; Index < Req->ChunkSize; Index++) {
+		EepromCache[Address + Index] = Req->BufferPtr[Req->Offset + Index];
+	}
+
+	Page = Address / PageSize;
+	if ((Req->ChunkSize == PageSize) &&
+	    ((CacheDirtyMap[Page / 32] & (1U << (Page % 32))) != 0U)) {
+		CacheDirtyMap[Page / 32] &= ~(1U << (Page % 32));
+		CacheDirtyCount--;
+	}
+}
+
+/*****************************************************************************/
+/**
+* This function fails the active request if it is polling for the end of a
+* write cycle past its deadline, so that an EEPROM that never acknowledges
+* again does not hold up the queue. The next request is started.
+*
+* @param	None.
+*
+* @return	None.
+*
+* @note		Called from TimerHandler() in interrupt context or, without
+*		a wakeup timer, from the application with the exceptions
+*		disabled.
+*
+******************************************************************************/
+static void EepromQueueCheckDeadline(void)
+{
+	EepromRequest *Req;
+	XTime Now;
+
+	if (QueueStats.Depth == 0U) {
+		return;
+	}
+
+	Req = RequestQueue[QueueHead];
+	XTime_GetTime(&Now);
+	if ((Req->Phase != EEPROM_PHASE_WRITE_CYCLE) || (Now < QueueDeadline)) {
+		return;
+	}
+
+	XIicPs_DisableSlaveMonitor(Req->IicPtr);
+	Stats.Nacks++;
+	EepromQueueRecord(IIC_STATS_WRITE_WAIT);
+	EepromQueueComplete(XST_FAILURE);
+}
+
+/*****************************************************************************/
+/**
+* This function completes the active request, calls its callback and starts
+* the next request in the queue.
+*
+* @param	Status is the completion status of the request.
+*
+* @return	None.
+*
+* @note		Called from interrupt context or with the exceptions disabled.
+*
+******************************************************************************/
+static void EepromQueueComplete(int Status)
+{
+	EepromRequest *Req = RequestQueue[QueueHead];
+	XTime Now;
+
+	XTime_GetTime(&Now);
+	QueueStats.LatencyLast = Now - Req->SubmitTime;
+	QueueStats.LatencyTotal += QueueStats.LatencyLast;
+	if (QueueStats.LatencyLast > QueueStats.LatencyMax) {
+		QueueStats.LatencyMax = QueueStats.LatencyLast;
+	}
+	if (Status == XST_SUCCESS) {
+		QueueStats.Completed++;
+	} else {
+		QueueStats.Failed++;
+	}
+
+	QueueHead = (QueueHead + 1U) % EEPROM_QUEUE_DEPTH;
+	QueueStats.Depth--;
+	QueueStats.InFlight = 0;
+
+	Req->Status = Status;
+	if (Req->Callback != NULL) {
+		Req->Callback(Req);
+	}
+
+	if (QueueStats.Depth != 0U) {
+		EepromQueueStep(RequestQueue[QueueHead]);
+	}
+}
+
+/*****************************************************************************/
+/**
+* This function stops the transfer of the active request and drops all the
+* pending requests, which complete with XST_FAILURE. Their callbacks are not
+* called.
+*
+* @param	None.
+*
+* @return	None.
+*
+* @note		Call this before the memory of the requests goes away while
+*		they may still be pending, for example on a timeout.
+*
+******************************************************************************/
+static void EepromQueueAbort(void)
+{
+	EepromRequest *Req;
+
+	Xil_ExceptionDisable();
+	if (QueueStats.Depth != 0U) {
+		Req = RequestQueue[QueueHead];
+		if (Req->Phase == EEPROM_PHASE_WRITE_CYCLE) {
+			IicPsTimerStop();
+			XIicPs_DisableSlaveMonitor(Req->IicPtr);
+		} else {
+			XIicPs_Abort(Req->IicPtr);
+		}
+		XIicPs_ClearOptions(Req->IicPtr, XIICPS_REP_START_OPTION);
+	}
+
+	while (QueueStats.Depth != 0U) {
+		Req = RequestQueue[QueueHead];
+		Req->Status = XST_FAILURE;
+		QueueStats.Failed++;
+		QueueHead = (QueueHead + 1U) % EEPROM_QUEUE_DEPTH;
+		QueueStats.Depth--;
+	}
+	QueueStats.InFlight = 0;
+	Xil_ExceptionEnable();
+}
+
+/*****************************************************************************/
+/**
+* This function is the completion callback of the requests of
+* EepromQueueExample(), it counts the completed requests.
+*
+* @param	Req is the completed request.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void EepromQueueDone(EepromRequest *Req)
+{
+	(*(volatile u32 *)Req->CallBackRef)++;
+}
+
+/*****************************************************************************/
+/**
+* This function queues EEPROM_QUEUE_DEPTH / 2 writes of two pages followed by
+* reads of the same areas, keeps running while Handler() serves them and
+* verifies the data.
+*
+* @param	IicInstance is a pointer to the IIC driver instance.
+*
+* @return	XST_SUCCESS if successful else XST_FAILURE.
+*
+* @note		None.
+*
+******************************************************************************/
+static int EepromQueueExample(XIicPs *IicInstance, IicPsFlags *Flags)
+{
+	EepromRequest Requests[EEPROM_QUEUE_DEPTH];
+	u32 NumWrites = EEPROM_QUEUE_DEPTH / 2U;
+	u32 ByteCount = 2U * PageSize;
+	u8 *ReadBackPtr = &VerifyBuffer[NumWrites * ByteCount];
+	volatile u32 DoneCount = 0;
+	u32 IdleLoops = 0;
+	XTime StartTime, Now;
+	u32 Index;
+	int Status;
+
+	for (Index = 0; Index < NumWrites * ByteCount; Index++) {
+		VerifyBuffer[Index] = (u8)(Index * 3U);
+		ReadBackPtr[Index] = 0;
+	}
+
+	for (Index = 0; Index < EEPROM_QUEUE_DEPTH; Index++) {
+		Requests[Index].Type = (Index < NumWrites) ? EEPROM_REQ_WRITE :
+							      EEPROM_REQ_READ;
+		Requests[Index].Address = EEPROM_START_ADDRESS +
+					  (Index % NumWrites) * ByteCount;
+		Requests[Index].BufferPtr = (Index < NumWrites) ?
+			&VerifyBuffer[Index * ByteCount] :
+			&ReadBackPtr[(Index % NumWrites) * ByteCount];
+		Requests[Index].ByteCount = ByteCount;
+		Requests[Index].Callback = EepromQueueDone;
+		Requests[Index].CallBackRef = (void *)&DoneCount;
+
+		Status = EepromSubmit(IicInstance, &Requests[Index]);
+		if (Status != XST_SUCCESS) {
+			EepromQueueAbort();
+			return XST_FAILURE;
+		}
+	}
+
+	/*
+	 * The application keeps running while the queue is served.
+	 */
+	XTime_GetTime(&StartTime);
+	while (DoneCount < EEPROM_QUEUE_DEPTH) {
+		IdleLoops++;
+		if (TimerReady == FALSE) {
+			Xil_ExceptionDisable();
+			EepromQueueCheckDeadline();
+			Xil_ExceptionEnable();
+		}
+		XTime_GetTime(&Now);
+		if ((Now - StartTime) >= US_TO_COUNTS(EEPROM_QUEUE_TIMEOUT_US)) {
+			/*
+			 * The requests live on this stack frame, none may
+			 * stay queued past the return.
+			 */
+			EepromQueueAbort();
+			return XST_FAILURE;
+		}
+	}
+
+	for (Index = 0; Index < EEPROM_QUEUE_DEPTH; Index++) {
+		if (Requests[Index].Status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+	}
+	for (Index = 0; Index < NumWrites * ByteCount; Index++) {
+		if (ReadBackPtr[Index] != VerifyBuffer[Index]) {
+			return XST_FAILURE;
+		}
+	}
+
+	xil_printf("Queue: %d requests, max depth %d, latency avg %d us, "
+		   "max %d us, %d application loops\r\n", QueueStats.Completed,
+		   QueueStats.MaxDepth,
+		   (u32)COUNTS_TO_US(QueueStats.LatencyTotal /
+				     (QueueStats.Completed + QueueStats.Failed)),
+		   (u32)COUNTS_TO_US(QueueStats.LatencyMax), IdleLoops);
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* This function initializes the driver instance of a controller for the
+* concurrent example and connects its interrupt.
+*
+* @param	Ctrl is the controller to initialize.
+* @param	DeviceId is the Device ID of the controller.
+*
+* @return	XST_SUCCESS if successful else XST_FAILURE.
+*
+* @note		The interrupt controller must have been set up already, which
+*		the EEPROM search does through IicPsConfig(). The interrupt of
+*		the controller is routed to Ctrl from here on.
+*
+******************************************************************************/
+static int IicPsControllerInit(IicPsController *Ctrl, u16 DeviceId)
+{
+	XIicPs_Config *ConfigPtr;
+	int Status;
+
+	Ctrl->DeviceId = DeviceId;
+	Ctrl->IsPresent = FALSE;
+
+	Ctrl->IntrId = IIC_INTR_ID(DeviceId);
+
+	/*
+	 * The interrupt is taken away from IicInstance.
+	 */
+	if (ActiveDeviceId == DeviceId) {
+		IicPsSessionClose();
+	}
+
+	ConfigPtr = XIicPs_LookupConfig(DeviceId);
+	if (ConfigPtr == NULL) {
+		return XST_FAILURE;
+	}
+
+	Status = XIicPs_CfgInitialize(&Ctrl->Instance, ConfigPtr,
+					ConfigPtr->BaseAddress);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	/*
+	 * The interrupt controller is set up here if the EEPROM search is
+	 * the first user of the interrupts.
+	 */
+	Status = SetupInterruptSystem(&Ctrl->Instance, Ctrl->IntrId);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	Ctrl->Flags.IicPtr = &Ctrl->Instance;
+	XIicPs_SetStatusHandler(&Ctrl->Instance, (void *)&Ctrl->Flags,
+				Handler);
+	XIicPs_SetSClk(&Ctrl->Instance, SClkRate);
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* This function completes the EEPROM that IicPsDiscover() found on a
+* controller with its geometry.
+*
+* @param	Ctrl is the controller, with an EEPROM present.
+*
+* @return	XST_SUCCESS if successful else XST_FAILURE.
+*
+* @note		The mux channel of the EEPROM must be selected, as
+*		IicPsDiscover() leaves it. The EEPROM under test is not probed
+*		again.
+*
+******************************************************************************/
+static int IicPsControllerGetGeometry(IicPsController *Ctrl)
+{
+	XIicPs *IicPtr = &Ctrl->Instance;
+	EepromDevice *Eeprom = &Ctrl->Eeprom;
+	u16 SavedSlvAddr = EepromSlvAddr;
+	int Status = XST_SUCCESS;
+
+	if ((Ctrl->DeviceId == EepromDeviceId) &&
+		   (Eeprom->SlvAddr == SavedSlvAddr) &&
+		   (Eeprom->MuxAddr == EepromMuxAddr) &&
+		   (Eeprom->MuxChannel == EepromMuxChannel)) {
+		Eeprom->PageSize = PageSize;
+		Eeprom->AddrBytes = (u8)EepromAddrBytes;
+		Eeprom->BlockMask = EepromBlockMask;
+		Eeprom->Size = EepromSize;
+	} else {
+		EepromSlvAddr = Eeprom->SlvAddr;
+		Status = EepromGetGeometry(IicPtr, &Ctrl->Flags, Ctrl->DeviceId,
+					   Eeprom);
+		EepromSlvAddr = SavedSlvAddr;
+	}
+
+	return Status;
+}
+
+/*****************************************************************************/
+/**
+* This function searches all the controllers for an EEPROM at the same time.
+*
+* Every controller runs the search of IicPsDiscoverStep() with its own slave
+* monitor. One probe is kept running on each controller and the next one is
+* started as soon as it is answered or times out, so the timeouts of absent
+* devices on the different buses overlap and the search takes about as long
+* as the one of the slowest controller. The probes are counted in
+* ProbeCount and ProbeTime.
+*
+* @param	Ctrls is the array of controllers, initialized with
+*		IicPsControllerInit().
+* @param	NumCtrls is the number of entries in Ctrls.
+*
+* @return	XST_SUCCESS if the search completed, whether or not EEPROMs
+*		were found, else XST_FAILURE. IsPresent and Eeprom of each
+*		controller describe the result, and SearchTime the time the
+*		search of the controller took.
+*
+* @note		The mux channel of a found EEPROM is left selected, the
+*		channels of the other muxes are closed.
+*
+******************************************************************************/
+static int IicPsDiscover(IicPsController *Ctrls, u32 NumCtrls)
+{
+	IicPsController *Ctrl;
+	XTime StartTime, Now;
+	XTime Deadline;
+	u32 Pending;
+	u32 Acked;
+	u32 Index;
+	u16 Address;
+
+	XTime_GetTime(&StartTime);
+	for (Index = 0; Index < NumCtrls; Index++) {
+		Ctrls[Index].IsPresent = FALSE;
+		Ctrls[Index].ProbeActive = FALSE;
+		Ctrls[Index].SearchState = IIC_SEARCH_START;
+		IicPsDiscoverStep(&Ctrls[Index], FALSE);
+	}
+
+	/*
+	 * An absent slave raises no interrupt at all. Between the passes
+	 * the core sleeps until a slave answers or the earliest probe of the
+	 * controllers times out. The timeouts are checked against the time
+	 * the sleep returned, the timer is read again to start a probe.
+	 */
+	XTime_GetTime(&Now);
+	do {
+		Pending = 0;
+		Deadline = 0;
+		for (Index = 0; Index < NumCtrls; Index++) {
+			Ctrl = &Ctrls[Index];
+			if (Ctrl->SearchState == IIC_SEARCH_DONE) {
+				continue;
+			}
+
+			Acked = (Ctrl->Flags.SlaveResponse != FALSE) ?
+				TRUE : FALSE;
+			if ((Ctrl->ProbeActive != FALSE) && (Acked == FALSE) &&
+			    ((Now - Ctrl->ProbeStart) <
+			     US_TO_COUNTS(ProbeTimeoutUs))) {
+				/*
+				 * The probe is still running.
+				 */
+			} else {
+				if (Ctrl->ProbeActive != FALSE) {
+					XIicPs_DisableSlaveMonitor(&Ctrl->Instance);
+					if (Acked == FALSE) {
+						Stats.Nacks++;
+					}
+					Ctrl->ProbeActive = FALSE;
+					ProbeCount++;
+					ProbeTime += Now - Ctrl->ProbeStart;
+					IicPsStatsAdd(IIC_STATS_PROBE,
+						      Now - Ctrl->ProbeStart);
+
+					IicPsDiscoverStep(Ctrl, Acked);
+					if (Ctrl->SearchState == IIC_SEARCH_DONE) {
+						Ctrl->SearchTime = Now - StartTime;
+						continue;
+					}
+				}
+
+				XTime_GetTime(&Now);
+				Address = (Ctrl->SearchState == IIC_SEARCH_MUX) ?
+					  MuxAddr[Ctrl->SearchMux] :
+					  EepromAddr[Ctrl->SearchIndex];
+				Ctrl->Flags.SlaveResponse = FALSE;
+				XIicPs_DisableAllInterrupts(
+					Ctrl->Instance.Config.BaseAddress);
+				XIicPs_EnableSlaveMonitor(&Ctrl->Instance, Address);
+				Ctrl->ProbeStart = Now;
+				Ctrl->ProbeActive = TRUE;
+			}
+
+			Pending++;
+			if ((Deadline == 0U) || (Ctrl->ProbeStart +
+			     US_TO_COUNTS(ProbeTimeoutUs) < Deadline)) {
+				Deadline = Ctrl->ProbeStart +
+					   US_TO_COUNTS(ProbeTimeoutUs);
+			}
+		}
+
+		if (Pending > 0U) {
+			Now = IicPsWaitEventUntil(Deadline);
+		}
+	} while (Pending > 0U);
+
+	for (Index = 0; Index < NumCtrls; Index++) {
+		if (Ctrls[Index].SearchStatus != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+	}
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* This function takes the EEPROM search on one controller a step further,
+* after a probe was answered or timed out.
+*
+* The muxes in MuxAddr[] are probed on the root segment, or behind the mux
+* channel MuxTree[] places them on. Behind a mux that
+* answers, the addresses in EepromAddr[] are probed with all the channels
+* open, so an absent EEPROM costs one probe timeout instead of one per
+* channel. An address that answers is then probed behind each channel
+* alone, from the first one, to find the channel. Without an EEPROM behind
+* the muxes, the addresses are probed on the root segment.
+*
+* @param	Ctrl is the controller. A search is begun with SearchState
+*		set to IIC_SEARCH_START.
+* @param	Acked is TRUE if the last probe was answered, else FALSE.
+*
+* @return	None. The next address to probe follows from SearchState,
+*		SearchMux and SearchIndex, until SearchState is
+*		IIC_SEARCH_DONE. SearchStatus is XST_FAILURE if a mux could
+*		not be set.
+*
+* @note		The mux selects are written in the step, the probes are run
+*		by IicPsDiscover().
+*
+******************************************************************************/
+static void IicPsDiscoverStep(IicPsController *Ctrl, u32 Acked)
+{
+	XIicPs *IicPtr = &Ctrl->Instance;
+	IicPsMuxNode *Node;
+	int Status = XST_SUCCESS;
+
+	switch (Ctrl->SearchState) {
+	case IIC_SEARCH_START:
+		Ctrl->SearchStatus = XST_SUCCESS;
+		Ctrl->SearchMux = 0;
+		Ctrl->SearchState = IIC_SEARCH_MUX;
+		break;
+
+	case IIC_SEARCH_MUX:
+		if (Acked != FALSE) {
+			Status = MuxInitChannel(IicPtr, &Ctrl->Flags,
+						MuxAddr[Ctrl->SearchMux],
+						IIC_ALL_CHANNELS);
+			Ctrl->SearchIndex = 0;
+			Ctrl->SearchState = IIC_SEARCH_BEHIND;
+		} else {
+			Ctrl->SearchMux++;
+		}
+		break;
+
+	case IIC_SEARCH_BEHIND:
+		if (Acked != FALSE) {
+			Ctrl->SearchChannel = 0x01;
+			Status = MuxInitChannel(IicPtr, &Ctrl->Flags,
+						MuxAddr[Ctrl->SearchMux],
+						Ctrl->SearchChannel);
+			Ctrl->SearchState = IIC_SEARCH_CHANNEL;
+		} else {
+			Ctrl->SearchIndex++;
+		}
+		break;
+
+	case IIC_SEARCH_CHANNEL:
+		if (Acked != FALSE) {
+			Ctrl->Eeprom.SlvAddr = EepromAddr[Ctrl->SearchIndex];
+			Ctrl->Eeprom.MuxAddr = MuxAddr[Ctrl->SearchMux];
+			Ctrl->Eeprom.MuxChannel = Ctrl->SearchChannel;
+			Ctrl->IsPresent = TRUE;
+			Ctrl->SearchState = IIC_SEARCH_DONE;
+			break;
+		}
+		Ctrl->SearchChannel = Ctrl->SearchChannel << 1;
+		if ((Ctrl->SearchChannel <= MAX_CHANNELS)) {
+			Status = MuxInitChannel(IicPtr, &Ctrl->Flags,
+						MuxAddr[Ctrl->SearchMux],
+						Ctrl->SearchChannel);
+		} else {
+			/*
+			 * It answered with all the channels open only.
+			 */
+			Status = MuxInitChannel(IicPtr, &Ctrl->Flags,
+						MuxAddr[Ctrl->SearchMux],
+						IIC_ALL_CHANNELS);
+			Ctrl->SearchIndex++;
+			Ctrl->SearchState = IIC_SEARCH_BEHIND;
+		}
+		break;
+
+	case IIC_SEARCH_ROOT:
+		if (Acked != FALSE) {
+			Ctrl->Eeprom.SlvAddr = EepromAddr[Ctrl->SearchIndex];
+			Ctrl->Eeprom.MuxAddr = 0;
+			Ctrl->Eeprom.MuxChannel = 0;
+			Ctrl->IsPresent = TRUE;
+			Ctrl->SearchState = IIC_SEARCH_DONE;
+		} else {
+			Ctrl->SearchIndex++;
+		}
+		break;
+
+	default:
+		break;
+	}
+
+	/*
+	 * Move on at the end of the address lists. The channels of a mux
+	 * are closed again before the next one is searched.
+	 */
+	if ((Ctrl->SearchState == IIC_SEARCH_BEHIND) &&
+	    (EepromAddr[Ctrl->SearchIndex] == 0) && (Status == XST_SUCCESS)) {
+		Status = MuxInitChannel(IicPtr, &Ctrl->Flags,
+					MuxAddr[Ctrl->SearchMux], 0x00);
+		Ctrl->SearchMux++;
+		Ctrl->SearchState = IIC_SEARCH_MUX;
+	}
+	while ((Ctrl->SearchState == IIC_SEARCH_MUX) &&
+	       (MuxAddr[Ctrl->SearchMux] != 0) && (Status == XST_SUCCESS)) {
+		/*
+		 * A cascaded mux is probed through the mux it is behind, and
+		 * skipped if that one is not there.
+		 */
+		Node = MuxGetNode(MuxAddr[Ctrl->SearchMux]);
+		if ((Node->ParentAddr == 0) ||
+		    (MuxRoute(IicPtr, &Ctrl->Flags, Node->ParentAddr,
+			      Node->ParentChannel) == XST_SUCCESS)) {
+			break;
+		}
+		Ctrl->SearchMux++;
+	}
+	if ((Ctrl->SearchState == IIC_SEARCH_MUX) &&
+	    (MuxAddr[Ctrl->SearchMux] == 0)) {
+		Ctrl->SearchIndex = 0;
+		Ctrl->SearchState = IIC_SEARCH_ROOT;
+	}
+	if ((Ctrl->SearchState == IIC_SEARCH_ROOT) &&
+	    (EepromAddr[Ctrl->SearchIndex] == 0)) {
+		Ctrl->SearchState = IIC_SEARCH_DONE;
+	}
+
+	if (Status != XST_SUCCESS) {
+		Ctrl->SearchStatus = XST_FAILURE;
+		Ctrl->SearchState = IIC_SEARCH_DONE;
+	}
+}
+
+/*****************************************************************************/
+/**
+* This function writes the job of every controller to its EEPROM, one page
+* per controller and round, and waits for the last write cycles.
+*
+* @param	Ctrls is the array of controllers.
+* @param	NumCtrls is the number of entries in Ctrls.
+*
+* @return	XST_SUCCESS if all the data was written, XST_FAILURE if an
+*		EEPROM did not accept a page within WriteTimeoutUs.
+*
+* @note		Controllers without an EEPROM are skipped. The mux channel of
+*		each EEPROM must be selected.
+*
+******************************************************************************/
+static int IicPsConcurrentWrite(IicPsController *Ctrls, u32 NumCtrls)
+{
+	IicPsController *Ctrl;
+	EepromWriteJob *Job;
+	u32 WrBfrOffset;
+	u32 Index, Offset;
+	u32 Pending;
+	XTime StartTime, Now;
+
+	XTime_GetTime(&Now);
+	for (Index = 0; Index < NumCtrls; Index++) {
+		Ctrls[Index].Job.LastProgress = Now;
+	}
+
+	do {
+		Pending = 0;
+		/*
+		 * Start the next page on every controller, the transfers run
+		 * on the buses at the same time.
+		 */
+		XTime_GetTime(&StartTime);
+		for (Index = 0; Index < NumCtrls; Index++) {
+			Ctrl = &Ctrls[Index];
+			Job = &Ctrl->Job;
+			Ctrl->ChunkSize = 0;
+			if ((Ctrl->IsPresent == FALSE) || (Job->ByteCount == 0U)) {
+				continue;
+			}
+			Pending++;
+
+			Ctrl->ChunkSize = Ctrl->Eeprom.PageSize -
+					  (Job->Address % Ctrl->Eeprom.PageSize);
+			if (Ctrl->ChunkSize > Job->ByteCount) {
+				Ctrl->ChunkSize = Job->ByteCount;
+			}
+			WrBfrOffset = EepromDeviceFillAddress(&Ctrl->Eeprom,
+							      Ctrl->WriteBuffer,
+							      Job->Address,
+							      &Ctrl->BlockSlvAddr);
+			for (Offset = 0; Offset < Ctrl->ChunkSize; Offset++) {
+				Ctrl->WriteBuffer[WrBfrOffset + Offset] =
+					Job->BufferPtr[Offset];
+			}
+
+			Ctrl->Flags.TransmitComplete = FALSE;
+			Ctrl->Flags.TotalErrorCount = 0;
+			XIicPs_MasterSend(&Ctrl->Instance, Ctrl->WriteBuffer,
+					  WrBfrOffset + Ctrl->ChunkSize,
+					  Ctrl->BlockSlvAddr);
+		}
+
+		/*
+		 * Collect the results. An EEPROM still programming the
+		 * previous page NACKs and gets the page again next round.
+		 */
+		for (Index = 0; Index < NumCtrls; Index++) {
+			Ctrl = &Ctrls[Index];
+			Job = &Ctrl->Job;
+			if (Ctrl->ChunkSize == 0U) {
+				continue;
+			}
+
+			while ((Ctrl->Flags.TransmitComplete == FALSE) &&
+			       (Ctrl->Flags.TotalErrorCount == 0U)) {
+				IicPsWaitEvent();
+			}
+			IicPsWaitBusIdle(&Ctrl->Instance);
+
+			XTime_GetTime(&Now);
+			if (Ctrl->Flags.TotalErrorCount != 0U) {
+				PipelineBusyCount++;
+				if ((Now - Job->LastProgress) >=
+				    US_TO_COUNTS(WriteTimeoutUs)) {
+					return XST_FAILURE;
+				}
+				continue;
+			}
+
+			IicPsStatsBytes(FALSE, Ctrl->Eeprom.AddrBytes +
+					Ctrl->ChunkSize);
+			IicPsStatsAdd(IIC_STATS_SEND, Now - StartTime);
+
+			Job->LastProgress = Now;
+			Job->Address += Ctrl->ChunkSize;
+			Job->BufferPtr += Ctrl->ChunkSize;
+			Job->ByteCount -= Ctrl->ChunkSize;
+			PageWriteCount++;
+		}
+	} while (Pending > 0U);
+
+	return IicPsConcurrentWaitWriteCycle(Ctrls, NumCtrls);
+}
+
+/*****************************************************************************/
+/**
+* This function waits for the write cycles of the EEPROMs on all the
+* controllers, polling them with the slave monitors at the same time.
+*
+* @param	Ctrls is the array of controllers.
+* @param	NumCtrls is the number of entries in Ctrls, at most 32.
+*
+* @return	XST_SUCCESS if every EEPROM responded, XST_FAILURE if one did
+*		not respond within WriteTimeoutUs.
+*
+* @note		In EEPROM_WAIT_FIXED_DELAY mode one fixed delay covers all
+*		the EEPROMs.
+*
+******************************************************************************/
+static int IicPsConcurrentWaitWriteCycle(IicPsController *Ctrls, u32 NumCtrls)
+{
+	XTime StartTime, Now, Deadline;
+	u32 BusyMask = 0;
+	u32 Index;
+
+	XTime_GetTime(&StartTime);
+	if (WriteWaitMode == EEPROM_WAIT_FIXED_DELAY) {
+		usleep(EEPROM_WRITE_DELAY_US);
+		IicPsStatsRecord(IIC_STATS_WRITE_WAIT, StartTime);
+		return XST_SUCCESS;
+	}
+
+	Deadline = StartTime + US_TO_COUNTS(WriteTimeoutUs);
+	for (Index = 0; Index < NumCtrls; Index++) {
+		if (Ctrls[Index].IsPresent == FALSE) {
+			continue;
+		}
+		Ctrls[Index].Flags.SlaveResponse = FALSE;
+		XIicPs_DisableAllInterrupts(
+			Ctrls[Index].Instance.Config.BaseAddress);
+		XIicPs_EnableSlaveMonitor(&Ctrls[Index].Instance,
+					  Ctrls[Index].Eeprom.SlvAddr);
+		BusyMask |= (u32)1U << Index;
+	}
+
+	XTime_GetTime(&Now);
+	while (BusyMask != 0U) {
+		for (Index = 0; Index < NumCtrls; Index++) {
+			if ((BusyMask & ((u32)1U << Index)) == 0U) {
+				continue;
+			}
+			if (Ctrls[Index].Flags.SlaveResponse) {
+				XIicPs_DisableSlaveMonitor(&Ctrls[Index].Instance);
+				BusyMask &= ~((u32)1U << Index);
+			}
+		}
+
+		if (BusyMask == 0U) {
+			break;
+		}
+		if (Now >= Deadline) {
+			for (Index = 0; Index < NumCtrls; Index++) {
+				if ((BusyMask & ((u32)1U << Index)) != 0U) {
+					XIicPs_DisableSlaveMonitor(
+						&Ctrls[Index].Instance);
+					Stats.Nacks++;
+				}
+			}
+			IicPsStatsAdd(IIC_STATS_WRITE_WAIT, Now - StartTime);
+			return XST_FAILURE;
+		}
+		Now = IicPsWaitEventUntil(Deadline);
+	}
+
+	IicPsStatsAdd(IIC_STATS_WRITE_WAIT, Now - StartTime);
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* This function reads the job of every controller from its EEPROM, in
+* transfers of at most XIICPS_MAX_TRANSFER_SIZE bytes.
+*
+* @param	Ctrls is the array of controllers.
+* @param	NumCtrls is the number of entries in Ctrls.
+*
+* @return	XST_SUCCESS if successful else XST_FAILURE.
+*
+* @note		The transfers of a round are started on all the controllers
+*		before waiting for any of them.
+*
+******************************************************************************/
+static int IicPsConcurrentRead(IicPsController *Ctrls, u32 NumCtrls)
+{
+	IicPsController *Ctrl;
+	EepromWriteJob *Job;
+	int Status = XST_SUCCESS;
+	u32 WrBfrOffset;
+	u32 Pending;
+	u32 Index;
+	XTime StartTime, RecvTime, Now;
+
+	do {
+		Pending = 0;
+		/*
+		 * Send the word address on every controller with the bus held.
+		 */
+		XTime_GetTime(&StartTime);
+		for (Index = 0; Index < NumCtrls; Index++) {
+			Ctrl = &Ctrls[Index];
+			Job = &Ctrl->Job;
+			Ctrl->ChunkSize = 0;
+			if ((Ctrl->IsPresent == FALSE) || (Job->ByteCount == 0U)) {
+				continue;
+			}
+			Pending++;
+
+			Ctrl->ChunkSize = (Job->ByteCount > XIICPS_MAX_TRANSFER_SIZE) ?
+					  XIICPS_MAX_TRANSFER_SIZE : Job->ByteCount;
+			WrBfrOffset = EepromDeviceFillAddress(&Ctrl->Eeprom,
+							      Ctrl->WriteBuffer,
+							      Job->Address,
+							      &Ctrl->BlockSlvAddr);
+
+			XIicPs_SetOptions(&Ctrl->Instance, XIICPS_REP_START_OPTION);
+			Ctrl->Flags.TransmitComplete = FALSE;
+			Ctrl->Flags.TotalErrorCount = 0;
+			XIicPs_MasterSend(&Ctrl->Instance, Ctrl->WriteBuffer,
+					  WrBfrOffset, Ctrl->BlockSlvAddr);
+		}
+
+		/*
+		 * Read the data after a repeated start on every controller.
+		 */
+		for (Index = 0; Index < NumCtrls; Index++) {
+			Ctrl = &Ctrls[Index];
+			if (Ctrl->ChunkSize == 0U) {
+				continue;
+			}
+
+			while (Ctrl->Flags.TransmitComplete == FALSE) {
+				if (0 != Ctrl->Flags.TotalErrorCount) {
+					break;
+				}
+				IicPsWaitEvent();
+			}
+			XIicPs_ClearOptions(&Ctrl->Instance, XIICPS_REP_START_OPTION);
+			if (0 != Ctrl->Flags.TotalErrorCount) {
+				Status = XST_FAILURE;
+				Ctrl->ChunkSize = 0;
+				continue;
+			}
+			IicPsStatsBytes(FALSE, Ctrl->Eeprom.AddrBytes);
+			IicPsStatsRecord(IIC_STATS_ADDRESS, StartTime);
+
+			Ctrl->Flags.ReceiveComplete = FALSE;
+			XIicPs_MasterRecv(&Ctrl->Instance, Ctrl->Job.BufferPtr,
+					  Ctrl->ChunkSize, Ctrl->BlockSlvAddr);
+		}
+
+		XTime_GetTime(&RecvTime);
+		for (Index = 0; Index < NumCtrls; Index++) {
+			Ctrl = &Ctrls[Index];
+			Job = &Ctrl->Job;
+			if (Ctrl->ChunkSize == 0U) {
+				continue;
+			}
+
+			while (Ctrl->Flags.ReceiveComplete == FALSE) {
+				if (0 != Ctrl->Flags.TotalErrorCount) {
+					Status = XST_FAILURE;
+					break;
+				}
+				IicPsWaitEvent();
+			}
+			IicPsWaitBusIdle(&Ctrl->Instance);
+			XTime_GetTime(&Now);
+			if (Ctrl->Flags.ReceiveComplete != FALSE) {
+				IicPsStatsBytes(TRUE, Ctrl->ChunkSize);
+				IicPsStatsAdd(IIC_STATS_RECV, Now - RecvTime);
+			}
+
+			Job->Address += Ctrl->ChunkSize;
+			Job->BufferPtr += Ctrl->ChunkSize;
+			Job->ByteCount -= Ctrl->ChunkSize;
+		}
+	} while ((Pending > 0U) && (Status == XST_SUCCESS));
+
+	return Status;
+}
+
+/*****************************************************************************/
+/**
+* This function writes EEPROM_PIPELINE_PAGES pages to an EEPROM on every PS
+* IIC controller at the same time, reads them back the same way and reports
+* the aggregate throughput.
+*
+* @param	None.
+*
+* @return	XST_SUCCESS if successful else XST_FAILURE.
+*
+* @note		The controller of the EEPROM under test is set up again for
+*		IicInstance on return.
+*
+******************************************************************************/
+static int IicPsConcurrentExample(void)
+{
+	IicPsController *Ctrl;
+	u32 NumCtrls = XPAR_XIICPS_NUM_INSTANCES;
+	u32 ByteCount = EEPROM_PIPELINE_PAGES * PageSize;
+	u32 NumPresent = 0;
+	u32 TotalBytes = 0;
+	XTime StartTime, EndTime;
+	int Status;
+	u32 Index, Offset;
+
+	for (Index = 0; Index < NumCtrls; Index++) {
+		Status = IicPsControllerInit(&IicControllers[Index], (u16)Index);
+		if (Status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+	}
+
+	Status = IicPsDiscover(IicControllers, NumCtrls);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	for (Index = 0; Index < NumCtrls; Index++) {
+		Ctrl = &IicControllers[Index];
+		if (Ctrl->IsPresent == FALSE) {
+			continue;
+		}
+		Status = IicPsControllerGetGeometry(Ctrl);
+		if (Status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+		NumPresent++;
+	}
+
+	for (Index = 0; Index < ByteCount; Index++) {
+		VerifyBuffer[Index] = (u8)(Index ^ 0xA5);
+	}
+
+	for (Index = 0; Index < NumCtrls; Index++) {
+		Ctrl = &IicControllers[Index];
+		Ctrl->Job.Device = &Ctrl->Eeprom;
+		Ctrl->Job.Address = EEPROM_START_ADDRESS;
+		Ctrl->Job.BufferPtr = VerifyBuffer;
+		Ctrl->Job.ByteCount = EEPROM_PIPELINE_PAGES *
+				      Ctrl->Eeprom.PageSize;
+		if (Ctrl->Job.ByteCount > ByteCount) {
+			Ctrl->Job.ByteCount = ByteCount;
+		}
+		if (Ctrl->Job.ByteCount > Ctrl->Eeprom.Size) {
+			Ctrl->Job.ByteCount = Ctrl->Eeprom.Size;
+		}
+		if (Ctrl->IsPresent != FALSE) {
+			TotalBytes += Ctrl->Job.ByteCount;
+		}
+	}
+
+	XTime_GetTime(&StartTime);
+	Status = IicPsConcurrentWrite(IicControllers, NumCtrls);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	XTime_GetTime(&EndTime);
+
+	xil_printf("Concurrent write of %d bytes on %d controllers in %d us, "
+		   "%d bytes/s\r\n", TotalBytes, NumPresent,
+		   (u32)COUNTS_TO_US(EndTime - StartTime),
+		   (EndTime == StartTime) ? 0U : (u32)((u64)TotalBytes *
+		   COUNTS_PER_SECOND / (EndTime - StartTime)));
+
+	/*
+	 * Read back into a separate area of VerifyBuffer per controller.
+	 */
+	for (Index = 0; Index < NumCtrls; Index++) {
+		Ctrl = &IicControllers[Index];
+		Ctrl->Job.ByteCount = Ctrl->Job.BufferPtr - VerifyBuffer;
+		Ctrl->Job.Address = EEPROM_START_ADDRESS;
+		Ctrl->Job.BufferPtr = &VerifyBuffer[(Index + 1U) * ByteCount];
+	}
+
+	XTime_GetTime(&StartTime);
+	Status = IicPsConcurrentRead(IicControllers, NumCtrls);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	XTime_GetTime(&EndTime);
+
+	for (Index = 0; Index < NumCtrls; Index++) {
+		Ctrl = &IicControllers[Index];
+		if (Ctrl->IsPresent == FALSE) {
+			continue;
+		}
+		for (Offset = 0; &VerifyBuffer[(Index + 1U) * ByteCount + Offset] <
+		     Ctrl->Job.BufferPtr; Offset++) {
+			if (VerifyBuffer[(Index + 1U) * ByteCount + Offset] !=
+			    VerifyBuffer[Offset]) {
+				return XST_FAILURE;
+			}
+		}
+	}
+
+	xil_printf("Concurrent read of %d bytes on %d controllers in %d us, "
+		   "%d bytes/s\r\n", TotalBytes, NumPresent,
+		   (u32)COUNTS_TO_US(EndTime - StartTime),
+		   (EndTime == StartTime) ? 0U : (u32)((u64)TotalBytes *
+		   COUNTS_PER_SECOND / (EndTime - StartTime)));
+
+	/*
+	 * Hand the controller of the EEPROM under test back to IicInstance.
+	 */
+	Status = IicPsConfig(EepromDeviceId, IIC_INTR_ID(EepromDeviceId));
+	if ((Status == XST_SUCCESS) && (EepromMuxAddr != 0)) {
+		Status = MuxRoute(&IicInstance, &IicFlags, EepromMuxAddr,
+				  EepromMuxChannel);
+	}
+
+	return Status;
+}
+
+/******************************************************************************/
+/**
+*
+* This function setups the interrupt system such that interrupts can occur
+* for the IIC.
+*
+* @param	IicPsPtr contains a pointer to the instance of the Iic
+*		which is going to be connected to the interrupt controller.
+*
+* @return	XST_SUCCESS if successful, otherwise XST_FAILURE.
+*
+* @note		The interrupt controller and the wakeup timer are
+*		initialized by the first call, later calls only connect and
+*		enable the interrupt.
+*
+*******************************************************************************/
+static int SetupInterruptSystem(XIicPs *IicPsPtr, u32 Int_Id)
+{
+	int Status;
+	XScuGic_Config *IntcConfig; /* Instance of the interrupt controller */
+
+	/*
+	 * The interrupt controller is set up by the first call only.
+	 */
+	if (IntcReady == FALSE) {
+		Xil_ExceptionInit();
+
+		/*
+		 * Initialize the interrupt controller driver so that it is
+		 * ready to use.
+		 */
+		IntcConfig = XScuGic_LookupConfig(INTC_DEVICE_ID);
+		if (NULL == IntcConfig) {
+			return XST_FAILURE;
+		}
+
+		Status = XScuGic_CfgInitialize(&InterruptController, IntcConfig,
+						IntcConfig->CpuBaseAddress);
+		if (Status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+
+		/*
+		 * Connect the interrupt controller interrupt handler to the
+		 * hardware interrupt handling logic in the processor.
+		 */
+		Xil_ExceptionRegisterHandler(XIL_EXCEPTION_ID_IRQ_INT,
+				(Xil_ExceptionHandler)XScuGic_InterruptHandler,
+				&InterruptController);
+		IntcReady = TRUE;
+
+#ifdef TTC_DEVICE_ID
+		/*
+		 * The waits spin if the wakeup timer cannot be set up.
+		 */
+		TimerReady = (IicPsTimerInit() == XST_SUCCESS) ? TRUE : FALSE;
+#endif
+	}
+
+	/*
+	 * Connect the device driver handler that will be called when an
+	 * interrupt for the device occurs, the handler defined above performs
+	 * the specific interrupt processing for the device.
+	 */
+	Status = XScuGic_Connect(&InterruptController, Int_Id,
+			(Xil_InterruptHandler)XIicPs_MasterInterruptHandler,
+			(void *)IicPsPtr);
+	if (Status != XST_SUCCESS) {
+		return Status;
+	}
+
+	/*
+	 * Enable the interrupt for the Iic device.
+	 */
+	XScuGic_Enable(&InterruptController, Int_Id);
+
+
+	/*
+	 * Enable interrupts in the Processor.
+	 */
+	Xil_ExceptionEnable();
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+*
+* This function is the handler which performs processing to handle data events
+* from the IIC.  It is called from an interrupt context such that the amount
+* of processing performed should be minimized.
+*
+* This handler provides an example of how to handle data for the IIC and
+* is application specific.
+*
+* @param	CallBackRef contains a callback reference from the driver, in
+*		this case it is the IicPsFlags of the driver instance.
+* @param	Event contains the specific kind of event that has occurred.
+* @param	EventData contains the number of bytes sent or received for sent
+*		and receive events.
+*
+* @return	None.
+*
+* @note		None.
+*
+*******************************************************************************/
+void Handler(void *CallBackRef, u32 Event)
+{
+	IicPsFlags *Flags = (IicPsFlags *)CallBackRef;
+
+	IicEventCount++;
+	IicPsStatsEvent(Event);
+
+	/*
+	 * While requests are queued the bus of the active request belongs
+	 * to the queue.
+	 */
+	if ((QueueStats.Depth != 0U) &&
+	    (RequestQueue[QueueHead]->IicPtr == Flags->IicPtr)) {
+		EepromQueueHandler(Event);
+		return;
+	}
+
+	/*
+	 * All of the data transfer has been finished.
+	 */
+
+	if (0 != (Event & XIICPS_EVENT_COMPLETE_SEND)) {
+		Flags->TransmitComplete = TRUE;
+	} else if (0 != (Event & XIICPS_EVENT_COMPLETE_RECV)){
+		Flags->ReceiveComplete = TRUE;
+	} else if (0 != (Event & XIICPS_EVENT_SLAVE_RDY)) {
+		Flags->SlaveResponse = TRUE;
+	} else if (0 != (Event & (XIICPS_EVENT_ERROR | XIICPS_EVENT_NACK |
+				  XIICPS_EVENT_ARB_LOST))) {
+		Flags->TotalErrorCount++;
+	}
+}
+
+/*****************************************************************************/
+/**
+*
+* This function puts the core to sleep until the status handler has seen a
+* driver event since the last call.
+*
+* The IRQ exception is masked while the event count is checked, so an event
+* arriving just before the WFI still wakes the core: a pending interrupt
+* ends the WFI even when it is masked, and is taken once the exception is
+* enabled again. The time spent asleep is added to CpuIdleTime.
+*
+* @param	None.
+*
+* @return	None.
+*
+* @note		Call this only in loops that end on an event the driver
+*		reports with an interrupt, for example a transfer completing
+*		or failing, or use IicPsWaitEventUntil(). Callers re-check
+*		their condition on return.
+*
+*******************************************************************************/
+static void IicPsWaitEvent(void)
+{
+	XTime StartTime, EndTime;
+
+	XTime_GetTime(&StartTime);
+	Xil_ExceptionDisable();
+	if (IicEventCount == IicEventsSeen) {
+		wfi();
+	}
+	IicEventsSeen = IicEventCount;
+	Xil_ExceptionEnable();
+	XTime_GetTime(&EndTime);
+
+	CpuIdleTime += EndTime - StartTime;
+}
+
+/*****************************************************************************/
+/**
+*
+* This function waits for a driver event like IicPsWaitEvent(), but no longer
+* than up to a deadline. It is meant for the waits on the slave monitor,
+* which raises no interrupt while the slave does not answer.
+*
+* The wakeup timer is armed to raise its interrupt at the deadline, so the
+* core sleeps in WFI either way, and its time is added to CpuIdleTime.
+* Without a wakeup timer the function spins until an event or the deadline
+* and its time is added to CpuBusyTime.
+*
+* @param	Deadline is the global timer value to return at the latest.
+*
+* @return	The global timer value on return, for the deadline check of
+*		the caller.
+*
+* @note		Callers re-check their condition and the deadline on return.
+*		The timer is read with the IRQ exception masked, so the
+*		reads do not hold up the sleep.
+*
+*******************************************************************************/
+static XTime IicPsWaitEventUntil(XTime Deadline)
+{
+	XTime StartTime, Now;
+
+	Xil_ExceptionDisable();
+	XTime_GetTime(&StartTime);
+	Now = StartTime;
+	if ((IicEventCount == IicEventsSeen) && (StartTime < Deadline)) {
+		if (IicPsTimerStart(StartTime, Deadline) != FALSE) {
+			wfi();
+			IicPsTimerStop();
+			XTime_GetTime(&Now);
+			CpuIdleTime += Now - StartTime;
+		} else {
+			Xil_ExceptionEnable();
+			while ((IicEventCount == IicEventsSeen) &&
+			       (Now < Deadline)) {
+				XTime_GetTime(&Now);
+			}
+			Xil_ExceptionDisable();
+			CpuBusyTime += Now - StartTime;
+		}
+	}
+	IicEventsSeen = IicEventCount;
+	Xil_ExceptionEnable();
+
+	return Now;
+}
+
+/*****************************************************************************/
+/**
+*
+* This function arms the wakeup timer to raise its interrupt once, at a
+* deadline.
+*
+* @param	Now is the current global timer value.
+* @param	Deadline is the global timer value to raise the interrupt at.
+*
+* @return	TRUE if the timer is armed, FALSE if there is no wakeup timer.
+*
+* @note		The timer is shared by IicPsWaitEventUntil() and the write
+*		cycle deadline of the request queue, which never run at the
+*		same time.
+*
+*******************************************************************************/
+static u32 IicPsTimerStart(XTime Now, XTime Deadline)
+{
+#ifdef TTC_DEVICE_ID
+	if (TimerReady == FALSE) {
+		return FALSE;
+	}
+
+	XTtcPs_Stop(&TtcInstance);
+	XTtcPs_SetInterval(&TtcInstance,
+			   (XInterval)(COUNTS_TO_US((Deadline > Now) ?
+						    (Deadline - Now) : 0U) + 1U) *
+			   (TtcInstance.Config.InputClockHz / 1000000U));
+	XTtcPs_ResetCounterValue(&TtcInstance);
+	XTtcPs_Start(&TtcInstance);
+
+	return TRUE;
+#else
+	(void)Now;
+	(void)Deadline;
+
+	return FALSE;
+#endif
+}
+
+/*****************************************************************************/
+/**
+*
+* This function stops the wakeup timer and clears its pending interrupt.
+*
+* @param	None.
+*
+* @return	None.
+*
+* @note		None.
+*
+*******************************************************************************/
+static void IicPsTimerStop(void)
+{
+#ifdef TTC_DEVICE_ID
+	if (TimerReady != FALSE) {
+		XTtcPs_Stop(&TtcInstance);
+		XTtcPs_ClearInterruptStatus(&TtcInstance,
+			XTtcPs_GetInterruptStatus(&TtcInstance));
+	}
+#endif
+}
+
+#ifdef TTC_DEVICE_ID
+/*****************************************************************************/
+/**
+*
+* This function sets up counter 0 of TTC0 as the wakeup timer: in interval
+* mode, stopped, with the interval interrupt connected to TimerHandler().
+*
+* @param	None.
+*
+* @return	XST_SUCCESS if successful, otherwise XST_FAILURE.
+*
+* @note		Called once the interrupt controller is set up.
+*
+*******************************************************************************/
+static int IicPsTimerInit(void)
+{
+	XTtcPs_Config *Config;
+	int Status;
+
+	Config = XTtcPs_LookupConfig(TTC_DEVICE_ID);
+	if (Config == NULL) {
+		return XST_FAILURE;
+	}
+
+	Status = XTtcPs_CfgInitialize(&TtcInstance, Config,
+				      Config->BaseAddress);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	XTtcPs_Stop(&TtcInstance);
+	XTtcPs_SetOptions(&TtcInstance, XTTCPS_OPTION_INTERVAL_MODE |
+			  XTTCPS_OPTION_WAVE_DISABLE);
+	XTtcPs_SetPrescaler(&TtcInstance, XTTCPS_CLK_CNTRL_PS_DISABLE);
+
+	Status = XScuGic_Connect(&InterruptController, TTC_INTR_ID,
+				 (Xil_InterruptHandler)TimerHandler,
+				 (void *)&TtcInstance);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	XTtcPs_EnableInterrupts(&TtcInstance, XTTCPS_IXR_INTERVAL_MASK);
+	XScuGic_Enable(&InterruptController, TTC_INTR_ID);
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+*
+* This function is the interrupt handler of the wakeup timer. It stops the
+* timer and counts a driver event, so that IicPsWaitEvent() returns, and
+* fails the active request of the queue if its write cycle deadline has
+* passed.
+*
+* @param	CallBackRef is the TTC instance.
+*
+* @return	None.
+*
+* @note		None.
+*
+*******************************************************************************/
+static void TimerHandler(void *CallBackRef)
+{
+	XTtcPs *TtcPtr = (XTtcPs *)CallBackRef;
+
+	XTtcPs_Stop(TtcPtr);
+	XTtcPs_ClearInterruptStatus(TtcPtr, XTtcPs_GetInterruptStatus(TtcPtr));
+	IicEventCount++;
+
+	if (QueueStats.Depth != 0U) {
+		EepromQueueCheckDeadline();
+	}
+}
+#endif
+
+/*****************************************************************************/
+/**
+*
+* This function waits until the bus is idle, after the STOP of the last
+* transfer. The controller raises no interrupt for this, so the wait spins
+* and its time is added to CpuBusyTime.
+*
+* @param	IicPtr is a pointer to the IIC driver instance.
+*
+* @return	None.
+*
+* @note		None.
+*
+*******************************************************************************/
+static void IicPsWaitBusIdle(XIicPs *IicPtr)
+{
+	XTime StartTime, EndTime;
+
+	XTime_GetTime(&StartTime);
+	while (XIicPs_BusIsBusy(IicPtr));
+	XTime_GetTime(&EndTime);
+
+	CpuBusyTime += EndTime - StartTime;
+}
+
+/*****************************************************************************/
+/**
+* This function returns the tracked state of a mux, taking a free entry of
+* MuxStates the first time the mux is seen.
+*
+* @param	IicPtr is a pointer to the IIC driver instance of the bus.
+* @param	MuxIicAddr is the address of the mux.
+*
+* @return	The state, or NULL if MuxStates is full.
+*
+* @note		None.
+*
+****************************************************************************/
+static IicPsMuxState *MuxGetState(XIicPs *IicPtr, u16 MuxIicAddr)
+{
+	IicPsMuxState *Free = NULL;
+	u32 Index;
+
+	for (Index = 0; Index < IIC_MUX_STATE_SIZE; Index++) {
+		if ((MuxStates[Index].MuxAddr == MuxIicAddr) &&
+		    (MuxStates[Index].DeviceId == IicPtr->Config.DeviceId)) {
+			return &MuxStates[Index];
+		}
+		if ((Free == NULL) && (MuxStates[Index].MuxAddr == 0)) {
+			Free = &MuxStates[Index];
+		}
+	}
+
+	if (Free != NULL) {
+		Free->DeviceId = IicPtr->Config.DeviceId;
+		Free->MuxAddr = MuxIicAddr;
+		Free->Valid = FALSE;
+	}
+	return Free;
+}
+
+/*****************************************************************************/
+/**
+* This function initializes the IIC MUX to select the required channel.
+*
+* The channel last selected on the mux is remembered, and selecting it again
+* costs no bus traffic. MuxSwitchCount and MuxSkipCount count the selects
+* written and skipped.
+*
+* @param	IicPtr is a pointer to the IIC driver instance of the bus.
+* @param	MuxAddress and Channel select value.
+*
+* @return	XST_SUCCESS if pass, otherwise XST_FAILURE.
+*
+* @note		With MuxVerifySelect the channel byte is read back and has to
+*		match. After a failure the channel of the mux is unknown and
+*		the next select is written.
+*
+****************************************************************************/
+static int MuxInitChannel(XIicPs *IicPtr, IicPsFlags *Flags, u16 MuxIicAddr, u8 WriteBuffer)
+{
+	IicPsMuxState *State;
+	XTime StartTime;
+	u8 Buffer = 0;
+
+	State = MuxGetState(IicPtr, MuxIicAddr);
+	if (State != NULL) {
+		if ((State->Valid != FALSE) && (State->Channel == WriteBuffer)) {
+			MuxSkipCount++;
+			return XST_SUCCESS;
+		}
+		State->Valid = FALSE;
+	}
+
+	Flags->TotalErrorCount = 0;
+	Flags->TransmitComplete = FALSE;
+	Flags->TotalErrorCount = 0;
+
+	MuxSwitchCount++;
+	XTime_GetTime(&StartTime);
+	XIicPs_MasterSend(IicPtr, &WriteBuffer,1,MuxIicAddr);
+	while (Flags->TransmitComplete == FALSE) {
+		if (0 != Flags->TotalErrorCount) {
+			return XST_FAILURE;
+		}
+		IicPsWaitEvent();
+	}
+	/*
+	 * Wait until bus is idle to start another transfer.
+	 */
+
+	IicPsWaitBusIdle(IicPtr);
+	IicPsStatsBytes(FALSE, 1);
+
+	if (MuxVerifySelect != FALSE) {
+		Flags->ReceiveComplete = FALSE;
+		/*
+		 * Receive the Data.
+		 */
+		XIicPs_MasterRecv(IicPtr, &Buffer,1, MuxIicAddr);
+
+		while (Flags->ReceiveComplete == FALSE) {
+			if (0 != Flags->TotalErrorCount) {
+				return XST_FAILURE;
+			}
+			IicPsWaitEvent();
+		}
+		/*
+		 * Wait until bus is idle to start another transfer.
+		 */
+		IicPsWaitBusIdle(IicPtr);
+		IicPsStatsBytes(TRUE, 1);
+
+		if (Buffer != WriteBuffer) {
+			return XST_FAILURE;
+		}
+	}
+	IicPsStatsRecord(IIC_STATS_MUX, StartTime);
+
+	if (State != NULL) {
+		State->Channel = WriteBuffer;
+		State->Valid = TRUE;
+	}
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* This function returns the MuxTree[] entry of a mux.
+*
+* @param	MuxIicAddr is the address of the mux.
+*
+* @return	The entry, or the terminating entry with ParentAddr 0 if the
+*		mux is on the root segment.
+*
+* @note		None.
+*
+****************************************************************************/
+static IicPsMuxNode *MuxGetNode(u16 MuxIicAddr)
+{
+	u32 Index;
+
+	for (Index = 0; MuxTree[Index].MuxAddr != 0; Index++) {
+		if (MuxTree[Index].MuxAddr == MuxIicAddr) {
+			break;
+		}
+	}
+	return &MuxTree[Index];
+}
+
+/*****************************************************************************/
+/**
+* This function selects a channel of a mux, first opening the path to the mux
+* through the muxes it is cascaded behind.
+*
+* The path is opened from the root segment down. MuxInitChannel() skips the
+* levels that are already set, so going to a device behind the same parent
+* channel writes the last level only. MuxLastRouteWrites holds the number of
+* selects written for this route.
+*
+* @param	IicPtr is a pointer to the IIC driver instance of the bus.
+* @param	MuxIicAddr is the address of the mux.
+* @param	Channel is the channel select value of the mux.
+*
+* @return	XST_SUCCESS if pass, otherwise XST_FAILURE.
+*
+* @note		A mux keeps its channel while the path to it is closed, so the
+*		channels remembered for the lower levels stay valid.
+*
+****************************************************************************/
+static int MuxRoute(XIicPs *IicPtr, IicPsFlags *Flags, u16 MuxIicAddr, u8 Channel)
+{
+	u16 PathAddr[IIC_MUX_MAX_DEPTH];
+	u8 PathChannel[IIC_MUX_MAX_DEPTH];
+	IicPsMuxNode *Node;
+	IicPsMuxRoute Leaf;
+	IicPsMuxRoute *Route;
+	u32 Depth = 0;
+	u32 Writes = MuxSwitchCount;
+	int Status = XST_SUCCESS;
+
+	Leaf.MuxAddr = MuxIicAddr;
+	Leaf.Channel = Channel;
+
+	/*
+	 * Walk from the mux up to the root segment.
+	 */
+	while ((MuxIicAddr != 0) && (Depth < IIC_MUX_MAX_DEPTH)) {
+		PathAddr[Depth] = MuxIicAddr;
+		PathChannel[Depth] = Channel;
+		Depth++;
+		Node = MuxGetNode(MuxIicAddr);
+		MuxIicAddr = Node->ParentAddr;
+		Channel = Node->ParentChannel;
+	}
+	if (MuxIicAddr != 0) {
+		return XST_FAILURE;
+	}
+
+	while ((Depth > 0) && (Status == XST_SUCCESS)) {
+		Depth--;
+		Status = MuxInitChannel(IicPtr, Flags, PathAddr[Depth],
+					PathChannel[Depth]);
+	}
+
+	MuxRouteCount++;
+	MuxLastRouteWrites = MuxSwitchCount - Writes;
+	MuxRouteWrites += MuxLastRouteWrites;
+	Route = &MuxRoutes[IicPtr->Config.DeviceId];
+	Route->MuxAddr = (Status == XST_SUCCESS) ? Leaf.MuxAddr : 0;
+	Route->Channel = Leaf.Channel;
+
+	return Status;
+}
+/*****************************************************************************/
+/**
+* This function perform the initial configuration for the IICPS Device.
+*
+* @param	DeviceId instance and Interrupt ID mapped to the device.
+*
+* @return	XST_SUCCESS if pass, otherwise XST_FAILURE.
+*
+* @note		None.
+*
+****************************************************************************/
+static int IicPsConfig(u16 DeviceId, u32 Int_Id)
+{
+	int Status;
+	XIicPs_Config *ConfigPtr;	/* Pointer to configuration data */
+	XTime StartTime, EndTime;
+
+	XTime_GetTime(&StartTime);
+
+	/*
+	 * The interrupt of the controller IicInstance was set up for is
+	 * routed to IicInstance as well, stop it.
+	 */
+	if ((ActiveDeviceId != IIC_NO_SESSION) && (ActiveDeviceId != DeviceId)) {
+		XScuGic_Disable(&InterruptController,
+				IIC_INTR_ID(ActiveDeviceId));
+	}
+	ActiveDeviceId = IIC_NO_SESSION;
+
+	/*
+	 * Initialize the IIC driver so that it is ready to use.
+	 */
+	ConfigPtr = XIicPs_LookupConfig(DeviceId);
+	if (ConfigPtr == NULL) {
+		return XST_FAILURE;
+	}
+
+	Status = XIicPs_CfgInitialize(&IicInstance, ConfigPtr,
+					ConfigPtr->BaseAddress);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	/*
+	 * Setup the Interrupt System.
+	 */
+	Status = SetupInterruptSystem(&IicInstance, Int_Id);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	/*
+	 * Setup the handlers for the IIC that will be called from the
+	 * interrupt context when data has been sent and received, specify
+	 * the completion flags of the instance as the callback reference so
+	 * the handler updates the flags the waits check.
+	 */
+	IicFlags.IicPtr = &IicInstance;
+	XIicPs_SetStatusHandler(&IicInstance, (void *)&IicFlags, Handler);
+
+	/*
+	 * Set the IIC serial clock rate.
+	 */
+	XIicPs_SetSClk(&IicInstance, SClkRate);
+	ActiveDeviceId = DeviceId;
+
+	XTime_GetTime(&EndTime);
+	ConfigCount++;
+	ConfigTime += EndTime - StartTime;
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* This function opens a probe session on a controller. IicInstance is set up
+* for the controller by IicPsConfig() unless it already is, so any number of
+* probes and transfers on the same controller share one set up.
+*
+* @param	DeviceId is the Device ID of the controller.
+*
+* @return	XST_SUCCESS if pass, otherwise XST_FAILURE.
+*
+* @note		The interrupt controller itself is set up only once, by the first session.
+*
+****************************************************************************/
+static int IicPsSessionOpen(u16 DeviceId)
+{
+	if (ActiveDeviceId == DeviceId) {
+		return XST_SUCCESS;
+	}
+
+	return IicPsConfig(DeviceId, IIC_INTR_ID(DeviceId));
+}
+
+/*****************************************************************************/
+/**
+* This function ends the probe session, so the next IicPsSessionOpen() sets
+* up IicInstance again.
+*
+* @param	None.
+*
+* @return	None.
+*
+* @note		Called when the interrupt of the controller is routed to
+*		another driver instance.
+*
+****************************************************************************/
+static void IicPsSessionClose(void)
+{
+	ActiveDeviceId = IIC_NO_SESSION;
+}
+
+static int IicPsFindDevice(u16 addr, u16 DeviceId)
+{
+	int Status;
+
+	Status = IicPsSlaveMonitor(addr, DeviceId);
+	if (Status == XST_SUCCESS) {
+		return XST_SUCCESS;
+	}
+	return XST_FAILURE;
+}
+/*****************************************************************************/
+/**
+* This function locates the EEPROM, trying the topology saved by the last
+* search before falling back to IicPsFindEeprom().
+*
+* The saved topology is validated with a probe of its mux, the selection of
+* the mux channel and a probe of the EEPROM, or with a single probe when
+* the EEPROM is on the root segment. A cascaded mux is probed through the
+* mux it is behind. The geometry is taken from the saved
+* topology. After a full search the new topology is saved.
+*
+* @param	Eeprom_Addr is filled with the slave address of the EEPROM.
+* @param	PageSize is filled with the page size of the EEPROM.
+*
+* @return	XST_SUCCESS if the EEPROM was found, otherwise XST_FAILURE.
+*
+* @note		None.
+*
+******************************************************************************/
+static int IicPsLocateEeprom(u16 *Eeprom_Addr, u32 *PageSize)
+{
+	EepromTopology Topology;
+	IicPsMuxNode *Node;
+	int Status = XST_FAILURE;
+
+	if ((EepromTopologyLoad(&Topology, sizeof(Topology)) ==
+	     sizeof(Topology)) &&
+	    (Topology.Magic == EEPROM_TOPOLOGY_MAGIC) &&
+	    (Topology.Checksum == EepromTopologyChecksum(&Topology)) &&
+	    (Topology.DeviceId < XPAR_XIICPS_NUM_INSTANCES)) {
+		if (Topology.MuxAddr != 0) {
+			Node = MuxGetNode(Topology.MuxAddr);
+			Status = IicPsSessionOpen(Topology.DeviceId);
+			if ((Status == XST_SUCCESS) && (Node->ParentAddr != 0)) {
+				Status = MuxRoute(&IicInstance, &IicFlags,
+						  Node->ParentAddr,
+						  Node->ParentChannel);
+			}
+			if (Status == XST_SUCCESS) {
+				Status = IicPsFindDevice(Topology.MuxAddr,
+							 Topology.DeviceId);
+			}
+			if (Status == XST_SUCCESS) {
+				Status = MuxRoute(&IicInstance, &IicFlags,
+						  Topology.MuxAddr,
+						  Topology.MuxChannel);
+			}
+			if (Status == XST_SUCCESS) {
+				Status = FindEepromDevice(&IicInstance,
+							  &IicFlags,
+							  Topology.SlvAddr);
+			}
+		} else {
+			Status = IicPsFindDevice(Topology.SlvAddr,
+						 Topology.DeviceId);
+		}
+	}
+
+	if (Status == XST_SUCCESS) {
+		*Eeprom_Addr = Topology.SlvAddr;
+		*PageSize = Topology.PageSize;
+		EepromDeviceId = Topology.DeviceId;
+		EepromMuxAddr = Topology.MuxAddr;
+		EepromMuxChannel = Topology.MuxChannel;
+		EepromAddrBytes = Topology.AddrBytes;
+		EepromBlockMask = Topology.BlockMask;
+		EepromSize = Topology.Size;
+		xil_printf("Using the saved topology, page size %d\r\n",
+			   *PageSize);
+		return XST_SUCCESS;
+	}
+
+	Status = IicPsFindEeprom(Eeprom_Addr, PageSize);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	Topology.Magic = EEPROM_TOPOLOGY_MAGIC;
+	Topology.DeviceId = EepromDeviceId;
+	Topology.MuxAddr = EepromMuxAddr;
+	Topology.SlvAddr = *Eeprom_Addr;
+	Topology.MuxChannel = EepromMuxChannel;
+	Topology.AddrBytes = EepromAddrBytes;
+	Topology.PageSize = *PageSize;
+	Topology.BlockMask = EepromBlockMask;
+	Topology.Size = EepromSize;
+	Topology.Checksum = EepromTopologyChecksum(&Topology);
+	EepromTopologySave(&Topology, sizeof(Topology));
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* This function computes the checksum of a saved topology.
+*
+* @param	TopologyPtr is the topology.
+*
+* @return	The inverted sum of all fields but the checksum.
+*
+* @note		None.
+*
+******************************************************************************/
+static u32 EepromTopologyChecksum(EepromTopology *TopologyPtr)
+{
+	u32 Sum;
+
+	Sum = TopologyPtr->Magic + TopologyPtr->DeviceId +
+	      TopologyPtr->MuxAddr + TopologyPtr->SlvAddr +
+	      TopologyPtr->MuxChannel + TopologyPtr->AddrBytes +
+	      TopologyPtr->PageSize + TopologyPtr->BlockMask +
+	      TopologyPtr->Size;
+
+	return ~Sum;
+}
+
+/*****************************************************************************/
+/**
+* This function reads the topology saved by EepromTopologySave().
+*
+* @param	BufferPtr is the buffer to fill.
+* @param	ByteCount is the size of the buffer.
+*
+* @return	The number of bytes read, 0 if nothing has been saved.
+*
+* @note		This default reads SavedTopology. A board with non-volatile
+*		storage can provide its own EepromTopologyLoad() and
+*		EepromTopologySave() to keep the topology across power cycles.
+*
+******************************************************************************/
+__attribute__((weak)) u32 EepromTopologyLoad(void *BufferPtr, u32 ByteCount)
+{
+	const u8 *SourcePtr = (const u8 *)&SavedTopology;
+	u32 Index;
+
+	if (ByteCount > sizeof(SavedTopology)) {
+		ByteCount = sizeof(SavedTopology);
+	}
+	for (Index = 0; Index < ByteCount; Index++) {
+		((u8 *)BufferPtr)[Index] = SourcePtr[Index];
+	}
+
+	return ByteCount;
+}
+
+/*****************************************************************************/
+/**
+* This function saves the topology found by the EEPROM search.
+*
+* @param	BufferPtr is the data to save.
+* @param	ByteCount is the number of bytes to save.
+*
+* @return	None.
+*
+* @note		This default writes SavedTopology.
+*
+******************************************************************************/
+__attribute__((weak)) void EepromTopologySave(const void *BufferPtr, u32 ByteCount)
+{
+	u8 *DestPtr = (u8 *)&SavedTopology;
+	u32 Index;
+
+	if (ByteCount > sizeof(SavedTopology)) {
+		ByteCount = sizeof(SavedTopology);
+	}
+	for (Index = 0; Index < ByteCount; Index++) {
+		DestPtr[Index] = ((const u8 *)BufferPtr)[Index];
+	}
+}
+
+/*****************************************************************************/
+/**
+* This function enumerates the devices on all the PS IIC controllers and
+* records them in DeviceTable.
+*
+* Every 7-bit address from IIC_ENUM_FIRST_ADDR to IIC_ENUM_LAST_ADDR is
+* probed on the root segment of each controller with the mux channels
+* closed, then behind every channel of each mux found. Devices that answer
+* behind a channel but also on the root segment, or on the channel a
+* cascaded mux is behind, are recorded only once.
+* The number of probes and the duration are kept in EnumProbeCount and
+* EnumTime.
+*
+* @param	None.
+*
+* @return	XST_SUCCESS if successful else XST_FAILURE.
+*
+* @note		A responding address is taken for a mux if it is listed in
+*		MuxAddr[] and found where MuxTree[] places it. The mux
+*		channels are left closed and IicInstance is set up for the
+*		last controller.
+*
+******************************************************************************/
+static int IicPsEnumerate(void)
+{
+	u32 SkipMap[4];
+	IicPsMuxNode *Node;
+	u32 ProbesBefore = ProbeCount;
+	u32 SavedTimeoutUs = ProbeTimeoutUs;
+	XTime StartTime, EndTime;
+	u32 MuxIndex, Index;
+	u8 MuxChannel;
+	u16 DeviceId;
+	int Status = XST_SUCCESS;
+
+	XTime_GetTime(&StartTime);
+	DeviceTableCount = 0;
+	ProbeTimeoutUs = IIC_ENUM_TIMEOUT_US;
+
+	for (DeviceId = 0; (DeviceId < XPAR_XIICPS_NUM_INSTANCES) &&
+	     (Status == XST_SUCCESS); DeviceId++) {
+		Status = IicPsSessionOpen(DeviceId);
+		if (Status != XST_SUCCESS) {
+			break;
+		}
+
+		/*
+		 * Close the channels of the known muxes so that the root
+		 * segment is scanned alone. A cascaded mux follows the mux
+		 * it is behind in MuxAddr[] and is closed before it.
+		 */
+		for (MuxIndex = 0; MuxAddr[MuxIndex] != 0; MuxIndex++);
+		while ((MuxIndex > 0U) && (Status == XST_SUCCESS)) {
+			MuxIndex--;
+			Node = MuxGetNode(MuxAddr[MuxIndex]);
+			if ((Node->ParentAddr != 0) &&
+			    (MuxRoute(&IicInstance, &IicFlags, Node->ParentAddr,
+				      Node->ParentChannel) != XST_SUCCESS)) {
+				continue;
+			}
+			if (FindEepromDevice(&IicInstance, &IicFlags,
+					     MuxAddr[MuxIndex]) == XST_SUCCESS) {
+				Status = MuxInitChannel(&IicInstance, &IicFlags,
+							MuxAddr[MuxIndex], 0x00);
+			}
+		}
+		if (Status != XST_SUCCESS) {
+			break;
+		}
+
+		for (Index = 0; Index < 4U; Index++) {
+			SkipMap[Index] = 0;
+		}
+		Status = IicPsEnumerateSegment(DeviceId, 0, 0, SkipMap);
+
+		/*
+		 * Scan behind every channel of the muxes found, the cascaded
+		 * ones as they are found behind a channel.
+		 */
+		for (Index = 0; (Index < DeviceTableCount) &&
+		     (Status == XST_SUCCESS); Index++) {
+			if ((DeviceTable[Index].DeviceId != DeviceId) ||
+			    (IicPsIsMux(&DeviceTable[Index]) == FALSE)) {
+				continue;
+			}
+			IicPsEnumerateSkipMap(DeviceId, DeviceTable[Index].Addr,
+					      SkipMap);
+
+			for (MuxChannel = 0x01; MuxChannel <= MAX_CHANNELS; MuxChannel = MuxChannel << 1) {
+				Status = IicPsEnumerateSegment(DeviceId,
+							       DeviceTable[Index].Addr,
+							       MuxChannel,
+							       SkipMap);
+				if (Status != XST_SUCCESS) {
+					break;
+				}
+			}
+			if (Status == XST_SUCCESS) {
+				Status = MuxInitChannel(&IicInstance, &IicFlags,
+							DeviceTable[Index].Addr,
+							0x00);
+			}
+		}
+
+		/*
+		 * Scanning a cascaded mux opened the path to it again.
+		 */
+		for (Index = 0; (Index < DeviceTableCount) &&
+		     (Status == XST_SUCCESS); Index++) {
+			if ((DeviceTable[Index].DeviceId == DeviceId) &&
+			    (DeviceTable[Index].MuxAddr == 0) &&
+			    (IicPsIsMux(&DeviceTable[Index]) != FALSE)) {
+				Status = MuxInitChannel(&IicInstance, &IicFlags,
+							DeviceTable[Index].Addr,
+							0x00);
+			}
+		}
+	}
+
+	ProbeTimeoutUs = SavedTimeoutUs;
+	XTime_GetTime(&EndTime);
+	EnumTime = EndTime - StartTime;
+	EnumProbeCount = ProbeCount - ProbesBefore;
+
+	return Status;
+}
+
+/*****************************************************************************/
+/**
+* This function probes all the addresses of one bus segment and adds the
+* responding devices to DeviceTable.
+*
+* @param	DeviceId is the controller, IicInstance must be set up for it.
+* @param	MuxIicAddr is the mux in front of the segment, 0 for the root.
+* @param	MuxChannel is the channel select value of the segment.
+* @param	SkipMap is the bitmap of the addresses skipped behind the mux
+*		channels, see IicPsEnumerateSkipMap(). It is filled when
+*		scanning the root.
+*
+* @return	XST_SUCCESS if successful else XST_FAILURE.
+*
+* @note		Devices beyond IIC_DEVICE_TABLE_SIZE are not recorded.
+*
+******************************************************************************/
+static int IicPsEnumerateSegment(u16 DeviceId, u16 MuxIicAddr, u8 MuxChannel, u32 *SkipMap)
+{
+	IicPsDeviceEntry *Entry;
+	int Status;
+	u16 Addr;
+
+	if (MuxIicAddr != 0) {
+		Status = MuxRoute(&IicInstance, &IicFlags, MuxIicAddr,
+				  MuxChannel);
+		if (Status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+	}
+
+	for (Addr = IIC_ENUM_FIRST_ADDR; Addr <= IIC_ENUM_LAST_ADDR; Addr++) {
+		if ((MuxIicAddr != 0) &&
+		    ((SkipMap[Addr / 32U] & ((u32)1U << (Addr % 32U))) != 0U)) {
+			continue;
+		}
+		if (FindEepromDevice(&IicInstance, &IicFlags, Addr) !=
+		    XST_SUCCESS) {
+			continue;
+		}
+
+		if (MuxIicAddr == 0) {
+			SkipMap[Addr / 32U] |= (u32)1U << (Addr % 32U);
+		}
+		if (DeviceTableCount < IIC_DEVICE_TABLE_SIZE) {
+			Entry = &DeviceTable[DeviceTableCount++];
+			Entry->DeviceId = DeviceId;
+			Entry->MuxAddr = MuxIicAddr;
+			Entry->MuxChannel = MuxChannel;
+			Entry->Addr = Addr;
+			Entry->Responds = TRUE;
+			Entry->Misses = 0;
+		}
+	}
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* This function builds the bitmap of the addresses to skip behind the
+* channels of a mux. Those are the devices in DeviceTable on the root segment
+* and on the mux channels the mux is cascaded behind, which answer behind
+* every channel of the mux.
+*
+* @param	DeviceId is the controller.
+* @param	MuxIicAddr is the mux.
+* @param	SkipMap is filled with the bitmap.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void IicPsEnumerateSkipMap(u16 DeviceId, u16 MuxIicAddr, u32 *SkipMap)
+{
+	IicPsDeviceEntry *Entry;
+	IicPsMuxNode *Node;
+	u32 Depth, Index;
+
+	for (Index = 0; Index < 4U; Index++) {
+		SkipMap[Index] = 0;
+	}
+
+	Node = MuxGetNode(MuxIicAddr);
+	for (Depth = 0; Depth <= IIC_MUX_MAX_DEPTH; Depth++) {
+		for (Index = 0; Index < DeviceTableCount; Index++) {
+			Entry = &DeviceTable[Index];
+			if ((Entry->DeviceId == DeviceId) &&
+			    (Entry->MuxAddr == Node->ParentAddr) &&
+			    ((Node->ParentAddr == 0) ||
+			     (Entry->MuxChannel == Node->ParentChannel))) {
+				SkipMap[Entry->Addr / 32U] |=
+					(u32)1U << (Entry->Addr % 32U);
+			}
+		}
+		if (Node->ParentAddr == 0) {
+			break;
+		}
+		Node = MuxGetNode(Node->ParentAddr);
+	}
+}
+
+/*****************************************************************************/
+/**
+* This function tells if a device of DeviceTable is a mux of MuxAddr[], on
+* the segment MuxTree[] places it.
+*
+* @param	Entry is the device.
+*
+* @return	TRUE if it is a mux, else FALSE.
+*
+* @note		None.
+*
+******************************************************************************/
+static u32 IicPsIsMux(IicPsDeviceEntry *Entry)
+{
+	IicPsMuxNode *Node;
+	u32 MuxIndex;
+
+	for (MuxIndex = 0; (MuxAddr[MuxIndex] != 0) &&
+	     (MuxAddr[MuxIndex] != Entry->Addr); MuxIndex++);
+	if (MuxAddr[MuxIndex] == 0) {
+		return FALSE;
+	}
+
+	Node = MuxGetNode(Entry->Addr);
+	if ((Entry->MuxAddr != Node->ParentAddr) ||
+	    ((Node->ParentAddr != 0) &&
+	     (Entry->MuxChannel != Node->ParentChannel))) {
+		return FALSE;
+	}
+	return TRUE;
+}
+
+/*****************************************************************************/
+/**
+* This function makes a device of DeviceTable accessible through
+* IicInstance, without searching the buses again.
+*
+* @param	Entry is the device.
+*
+* @return	XST_SUCCESS if successful else XST_FAILURE.
+*
+* @note		The controller is set up again only if the probe session is on
+*		another one.
+*
+******************************************************************************/
+static int IicPsSelectDevice(IicPsDeviceEntry *Entry)
+{
+	int Status;
+
+	Status = IicPsSessionOpen(Entry->DeviceId);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	if (Entry->MuxAddr != 0) {
+		Status = MuxRoute(&IicInstance, &IicFlags, Entry->MuxAddr,
+				  Entry->MuxChannel);
+		if (Status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+	}
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* This function enumerates the buses, prints the device table and reads the
+* EEPROM under test again through its table entry. Before that it goes to
+* each EEPROM behind a mux and prints the mux writes the route took.
+*
+* @param	None.
+*
+* @return	XST_SUCCESS if successful else XST_FAILURE.
+*
+* @note		None.
+*
+******************************************************************************/
+static int IicPsEnumerateExample(void)
+{
+	IicPsDeviceEntry *Entry = NULL;
+	int Status;
+	u32 Index, AddrIndex;
+
+	Status = IicPsEnumerate();
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	xil_printf("Bus scan: %d devices, %d probes in %d us\r\n",
+		   DeviceTableCount, EnumProbeCount,
+		   (u32)COUNTS_TO_US(EnumTime));
+	for (Index = 0; Index < DeviceTableCount; Index++) {
+		xil_printf("  I2C%d mux 0x%02X channel 0x%02X address 0x%02X\r\n",
+			   DeviceTable[Index].DeviceId, DeviceTable[Index].MuxAddr,
+			   DeviceTable[Index].MuxChannel, DeviceTable[Index].Addr);
+		if ((DeviceTable[Index].DeviceId == EepromDeviceId) &&
+		    (DeviceTable[Index].MuxAddr == EepromMuxAddr) &&
+		    (DeviceTable[Index].MuxChannel == EepromMuxChannel) &&
+		    (DeviceTable[Index].Addr == EepromSlvAddr)) {
+			Entry = &DeviceTable[Index];
+		}
+	}
+
+	if (Entry == NULL) {
+		return XST_FAILURE;
+	}
+
+	xil_printf("Mux: %d channel selects written, %d skipped\r\n",
+		   MuxSwitchCount, MuxSkipCount);
+
+	/*
+	 * Go to every EEPROM behind a mux in turn. Only the mux levels that
+	 * differ from the last route are written.
+	 */
+	for (Index = 0; Index < DeviceTableCount; Index++) {
+		for (AddrIndex = 0; (EepromAddr[AddrIndex] != 0) &&
+		     (EepromAddr[AddrIndex] != DeviceTable[Index].Addr);
+		     AddrIndex++);
+		if ((EepromAddr[AddrIndex] == 0) ||
+		    (DeviceTable[Index].MuxAddr == 0)) {
+			continue;
+		}
+		Status = IicPsSelectDevice(&DeviceTable[Index]);
+		if (Status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+
+		/*
+		 * A hot-plugged EEPROM may have gone since the bus scan.
+		 */
+		if (FindEepromDevice(&IicInstance, &IicFlags,
+				     DeviceTable[Index].Addr) != XST_SUCCESS) {
+			xil_printf("  Access I2C%d mux 0x%02X channel 0x%02X "
+				   "address 0x%02X: not answering\r\n",
+				   DeviceTable[Index].DeviceId,
+				   DeviceTable[Index].MuxAddr,
+				   DeviceTable[Index].MuxChannel,
+				   DeviceTable[Index].Addr);
+			continue;
+		}
+		xil_printf("  Access I2C%d mux 0x%02X channel 0x%02X address "
+			   "0x%02X: %d mux writes\r\n",
+			   DeviceTable[Index].DeviceId, DeviceTable[Index].MuxAddr,
+			   DeviceTable[Index].MuxChannel, DeviceTable[Index].Addr,
+			   MuxLastRouteWrites);
+	}
+
+	/*
+	 * Access the EEPROM under test through the table.
+	 */
+	Status = IicPsSelectDevice(Entry);
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	xil_printf("Routes: %d opened, %d mux writes, %d for the last\r\n",
+		   MuxRouteCount, MuxRouteWrites,
+		   (Entry->MuxAddr != 0) ? MuxLastRouteWrites : 0U);
+
+	return EepromReadData(&IicInstance, &IicFlags, ReadBuffer, 1,
+			      EEPROM_START_ADDRESS);
+}
+
+/*****************************************************************************/
+/**
+* This function sets the callback the hot-plug monitor calls when a device
+* of DeviceTable attaches or detaches.
+*
+* @param	CallBackRef is passed back to the callback.
+* @param	FuncPtr is the callback, NULL for none.
+*
+* @return	None.
+*
+* @note		The callback runs from IicPsMonitorPoll().
+*
+******************************************************************************/
+static void IicPsMonitorSetHandler(void *CallBackRef, IicPsMonitorHandler FuncPtr)
+{
+	MonitorCallBackRef = CallBackRef;
+	MonitorHandler = FuncPtr;
+}
+
+/*****************************************************************************/
+/**
+* This function starts the hot-plug monitor on the devices of DeviceTable.
+*
+* The addresses in EepromAddr[] behind every channel of the muxes in the
+* table are added as candidates that do not respond yet, so an EEPROM
+* plugged in later is reported as attached. Channels with a cascaded mux
+* behind them get no candidates, a device there could not be told from one
+* behind the cascaded mux.
+*
+* @param	None.
+*
+* @return	XST_SUCCESS if successful else XST_FAILURE.
+*
+* @note		DeviceTable must have been built by IicPsEnumerate().
+*		The instances of the other controllers are set up with
+*		IicPsControllerInit() if they are not yet, which routes their
+*		interrupts to them.
+*
+******************************************************************************/
+static int IicPsMonitorStart(void)
+{
+	IicPsDeviceEntry *Entry;
+	u32 NumEntries = DeviceTableCount;
+	u32 Index, AddrIndex, NodeIndex;
+	u8 MuxChannel;
+	u16 DeviceId;
+	int Status;
+
+	for (Index = 0; Index < NumEntries; Index++) {
+		Entry = &DeviceTable[Index];
+		if (IicPsIsMux(Entry) == FALSE) {
+			continue;
+		}
+
+		for (MuxChannel = 0x01; MuxChannel <= MAX_CHANNELS; MuxChannel = MuxChannel << 1) {
+			for (NodeIndex = 0; (MuxTree[NodeIndex].MuxAddr != 0) &&
+			     ((MuxTree[NodeIndex].ParentAddr != Entry->Addr) ||
+			      (MuxTree[NodeIndex].ParentChannel != MuxChannel));
+			     NodeIndex++);
+			if (MuxTree[NodeIndex].MuxAddr != 0) {
+				continue;
+			}
+			for (AddrIndex = 0; EepromAddr[AddrIndex] != 0;
+			     AddrIndex++) {
+				IicPsMonitorAdd(Entry->DeviceId, Entry->Addr,
+						MuxChannel, EepromAddr[AddrIndex]);
+			}
+		}
+	}
+
+	for (DeviceId = 0; DeviceId < XPAR_XIICPS_NUM_INSTANCES; DeviceId++) {
+		if ((DeviceId == ActiveDeviceId) ||
+		    (IicControllers[DeviceId].Instance.IsReady ==
+		     XIL_COMPONENT_IS_READY)) {
+			continue;
+		}
+		Status = IicPsControllerInit(&IicControllers[DeviceId], DeviceId);
+		if (Status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+	}
+
+	MonitorIndex = 0;
+	MonitorProbeCount = 0;
+	MonitorEventCount = 0;
+	MonitorBusTime = 0;
+	XTime_GetTime(&MonitorNext);
+	MonitorEnabled = TRUE;
+
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* This function stops the hot-plug monitor.
+*
+* @param	None.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void IicPsMonitorStop(void)
+{
+	MonitorEnabled = FALSE;
+}
+
+/*****************************************************************************/
+/**
+* This function adds a device to DeviceTable as a candidate of the hot-plug
+* monitor, unless it is in the table already.
+*
+* @param	DeviceId is the controller.
+* @param	MuxIicAddr is the mux in front of the device, 0 for the root.
+* @param	MuxChannel is the channel select value of the device.
+* @param	Addr is the 7-bit slave address.
+*
+* @return	None.
+*
+* @note		Candidates beyond IIC_DEVICE_TABLE_SIZE are not recorded.
+*
+******************************************************************************/
+static void IicPsMonitorAdd(u16 DeviceId, u16 MuxIicAddr, u8 MuxChannel, u16 Addr)
+{
+	IicPsDeviceEntry *Entry;
+	u32 Index;
+
+	for (Index = 0; Index < DeviceTableCount; Index++) {
+		Entry = &DeviceTable[Index];
+		if ((Entry->DeviceId == DeviceId) &&
+		    (Entry->MuxAddr == MuxIicAddr) &&
+		    (Entry->MuxChannel == MuxChannel) &&
+		    (Entry->Addr == Addr)) {
+			return;
+		}
+	}
+
+	if (DeviceTableCount < IIC_DEVICE_TABLE_SIZE) {
+		Entry = &DeviceTable[DeviceTableCount++];
+		Entry->DeviceId = DeviceId;
+		Entry->MuxAddr = MuxIicAddr;
+		Entry->MuxChannel = MuxChannel;
+		Entry->Addr = Addr;
+		Entry->Responds = FALSE;
+		Entry->Misses = 0;
+	}
+}
+
+/*****************************************************************************/
+/**
+* This function returns the driver instance the hot-plug monitor probes a
+* controller with, through its completion flags.
+*
+* @param	DeviceId is the controller.
+*
+* @return	The flags of IicInstance for the controller of the probe
+*		session, else the flags of the controller in IicControllers,
+*		or NULL if that one is not set up. IicPtr of the flags is the
+*		instance.
+*
+* @note		The interrupt of the controller is connected to the returned
+*		instance again.
+*
+******************************************************************************/
+static IicPsFlags *IicPsMonitorInstance(u16 DeviceId)
+{
+	if (DeviceId == ActiveDeviceId) {
+		return &IicFlags;
+	}
+	if (IicControllers[DeviceId].Instance.IsReady != XIL_COMPONENT_IS_READY) {
+		return NULL;
+	}
+
+	/*
+	 * A probe session on the controller connects its interrupt to
+	 * IicInstance and disables it when the session moves on.
+	 */
+	if (SetupInterruptSystem(&IicControllers[DeviceId].Instance,
+				 IicControllers[DeviceId].IntrId) != XST_SUCCESS) {
+		return NULL;
+	}
+
+	return &IicControllers[DeviceId].Flags;
+}
+
+/*****************************************************************************/
+/**
+* This function runs the hot-plug monitor. It is meant to be called often
+* from the foreground, between transfers, and does nothing until the next
+* probe is due.
+*
+* A due probe re-addresses the next entry of DeviceTable with the slave
+* monitor. The mux channel of a device behind a mux is selected for the
+* probe and the channel the foreground had selected is restored after it.
+* When the foreground is on the root segment, every mux on the path to the
+* device is closed again instead.
+* The callback is called when a device that did not respond answers, and
+* when a responding device misses IIC_MONITOR_MISSES probes in a row.
+*
+* The next probe is due MonitorPeriodUs after this one, or later if the
+* time this one took on the bus, mux selects included, would otherwise be
+* more than MonitorDutyPermille of the bus time.
+*
+* @param	None.
+*
+* @return	XST_SUCCESS if successful, else XST_FAILURE if the mux channel
+*		of the foreground could not be restored.
+*
+* @note		A probe blocks the caller for IIC_MONITOR_TIMEOUT_US at most,
+*		plus the mux selects.
+*
+******************************************************************************/
+static int IicPsMonitorPoll(void)
+{
+	IicPsDeviceEntry *Entry;
+	IicPsMuxRoute Saved = {0, 0};
+	IicPsFlags *Flags;
+	XIicPs *IicPtr;
+	u16 MuxIicAddr;
+	XTime StartTime, EndTime;
+	XTime BusTime, Pause;
+	u32 Acked = FALSE;
+	int Status = XST_SUCCESS;
+
+	if ((MonitorEnabled == FALSE) || (DeviceTableCount == 0U)) {
+		return XST_SUCCESS;
+	}
+
+	/*
+	 * The bus belongs to the request queue while it is busy.
+	 */
+	if (QueueStats.Depth != 0U) {
+		return XST_SUCCESS;
+	}
+
+	XTime_GetTime(&StartTime);
+	if (StartTime < MonitorNext) {
+		return XST_SUCCESS;
+	}
+
+	Entry = &DeviceTable[MonitorIndex];
+	MonitorIndex = (MonitorIndex + 1U) % DeviceTableCount;
+	Flags = IicPsMonitorInstance(Entry->DeviceId);
+	if (Flags == NULL) {
+		return XST_SUCCESS;
+	}
+	IicPtr = Flags->IicPtr;
+
+	if (Entry->MuxAddr != 0) {
+		Saved = MuxRoutes[Entry->DeviceId];
+		Status = MuxRoute(IicPtr, Flags, Entry->MuxAddr,
+				  Entry->MuxChannel);
+	}
+	if (Status == XST_SUCCESS) {
+		Acked = (IicPsProbe(IicPtr, Flags, Entry->Addr,
+				    IIC_MONITOR_TIMEOUT_US) == XST_SUCCESS) ?
+			TRUE : FALSE;
+	}
+
+	/*
+	 * Give the foreground its route back, MuxRoute() writes only the
+	 * levels that changed.
+	 */
+	Status = XST_SUCCESS;
+	if ((Entry->MuxAddr != 0) && (Saved.MuxAddr != 0)) {
+		Status = MuxRoute(IicPtr, Flags, Saved.MuxAddr, Saved.Channel);
+	} else if (Entry->MuxAddr != 0) {
+		/*
+		 * The foreground is on the root segment. Close the muxes from
+		 * the probed one up, so that no device behind them answers
+		 * in parallel with the foreground device.
+		 */
+		for (MuxIicAddr = Entry->MuxAddr; MuxIicAddr != 0;
+		     MuxIicAddr = MuxGetNode(MuxIicAddr)->ParentAddr) {
+			if (MuxInitChannel(IicPtr, Flags, MuxIicAddr, 0x00) !=
+			    XST_SUCCESS) {
+				Status = XST_FAILURE;
+			}
+		}
+		MuxRoutes[Entry->DeviceId] = Saved;
+	}
+
+	XTime_GetTime(&EndTime);
+	BusTime = EndTime - StartTime;
+	MonitorBusTime += BusTime;
+	MonitorProbeCount++;
+
+	Pause = US_TO_COUNTS(MonitorPeriodUs);
+	if ((MonitorDutyPermille != 0U) && (MonitorDutyPermille < 1000U) &&
+	    ((BusTime * (1000U - MonitorDutyPermille) / MonitorDutyPermille) >
+	     Pause)) {
+		Pause = BusTime * (1000U - MonitorDutyPermille) /
+			MonitorDutyPermille;
+	}
+	MonitorNext = EndTime + Pause;
+
+	if (Acked != FALSE) {
+		Entry->Misses = 0;
+		if (Entry->Responds == FALSE) {
+			Entry->Responds = TRUE;
+			MonitorEventCount++;
+			if (MonitorHandler != NULL) {
+				MonitorHandler(MonitorCallBackRef, Entry,
+					       IIC_MONITOR_ATTACH);
+			}
+		}
+	} else if (Entry->Responds != FALSE) {
+		Entry->Misses++;
+		if (Entry->Misses >= IIC_MONITOR_MISSES) {
+			Entry->Responds = FALSE;
+			Entry->Misses = 0;
+			MonitorEventCount++;
+			if (MonitorHandler != NULL) {
+				MonitorHandler(MonitorCallBackRef, Entry,
+					       IIC_MONITOR_DETACH);
+			}
+		}
+	}
+
+	return Status;
+}
+
+/*****************************************************************************/
+/**
+* This function is the callback of the hot-plug monitor in the example, it
+* reports the device.
+*
+* @param	CallBackRef is not used.
+* @param	Entry is the device.
+* @param	Event is IIC_MONITOR_ATTACH or IIC_MONITOR_DETACH.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void IicPsMonitorReport(void *CallBackRef, IicPsDeviceEntry *Entry, u32 Event)
+{
+	(void)CallBackRef;
+
+	xil_printf("%s I2C%d mux 0x%02X channel 0x%02X address 0x%02X\r\n",
+		   (Event == IIC_MONITOR_ATTACH) ? "Attached" : "Detached",
+		   Entry->DeviceId, Entry->MuxAddr, Entry->MuxChannel,
+		   Entry->Addr);
+}
+
+/*****************************************************************************/
+/**
+* This function runs the hot-plug monitor next to foreground reads of the
+* EEPROM under test for IIC_MONITOR_EXAMPLE_US and reports the share of the
+* bus time the monitor took.
+*
+* @param	None.
+*
+* @return	XST_SUCCESS if successful else XST_FAILURE.
+*
+* @note		DeviceTable must have been built by IicPsEnumerate(), with the
+*		EEPROM under test selected.
+*
+******************************************************************************/
+static int IicPsMonitorExample(void)
+{
+	XTime StartTime, Now;
+	u32 Reads = 0;
+	int Status;
+
+	IicPsMonitorSetHandler(NULL, IicPsMonitorReport);
+	Status = IicPsMonitorStart();
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	XTime_GetTime(&StartTime);
+	do {
+		Status = EepromReadData(&IicInstance, &IicFlags, ReadBuffer, 1,
+					EEPROM_START_ADDRESS);
+		if (Status == XST_SUCCESS) {
+			Reads++;
+			Status = IicPsMonitorPoll();
+		}
+		XTime_GetTime(&Now);
+	} while ((Status == XST_SUCCESS) &&
+		 ((Now - StartTime) < US_TO_COUNTS(IIC_MONITOR_EXAMPLE_US)));
+	IicPsMonitorStop();
+
+	xil_printf("Monitor: %d devices, %d probes, %d events, %d us of bus "
+		   "time in %d us, %d foreground reads\r\n", DeviceTableCount,
+		   MonitorProbeCount, MonitorEventCount,
+		   (u32)COUNTS_TO_US(MonitorBusTime),
+		   (u32)COUNTS_TO_US(Now - StartTime), Reads);
+
+	return Status;
+}
+
+/*****************************************************************************/
+/**
+* This function is use to figure out the Eeprom slave device
+*
+* All the controllers are searched at the same time with IicPsDiscover(),
+* the EEPROM found on the first one is taken. IicInstance is set up for its
+* controller and the mux channel in front of it is selected.
+*
+* @param	Eeprom_Addr is filled with the slave address of the EEPROM.
+* @param	PageSize is filled with the page size of the EEPROM.
+*
+* @return	XST_SUCCESS if successful and also update the epprom slave
+* device address in addr variable else XST_FAILURE.
+*
+* @note		The search takes about as long as the one of the slowest
+*		controller, DiscoverTime.
+*
+******************************************************************************/
+static int IicPsFindEeprom(u16 *Eeprom_Addr,u32 *PageSize)
+{
+	IicPsController *Ctrl = NULL;
+	EepromDevice Device;
+	u32 NumCtrls = XPAR_XIICPS_NUM_INSTANCES;
+	XTime StartTime, EndTime;
+	XTime Slowest = 0;
+	int Status;
+	u32 Index;
+
+	XTime_GetTime(&StartTime);
+	for (Index = 0; Index < NumCtrls; Index++) {
+		Status = IicPsControllerInit(&IicControllers[Index], (u16)Index);
+		if (Status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+	}
+
+	Status = IicPsDiscover(IicControllers, NumCtrls);
+	if (Status != XST_SUCCESS) {
+		xil_printf("Failed to enable the MUX channel\r\n");
+		return XST_FAILURE;
+	}
+	XTime_GetTime(&EndTime);
+	DiscoverTime = EndTime - StartTime;
+
+	for (Index = NumCtrls; Index > 0U; Index--) {
+		if (IicControllers[Index - 1U].IsPresent != FALSE) {
+			Ctrl = &IicControllers[Index - 1U];
+		}
+		if (IicControllers[Index - 1U].SearchTime > Slowest) {
+			Slowest = IicControllers[Index - 1U].SearchTime;
+		}
+	}
+	xil_printf("Searched %d controllers in %d us, slowest %d us\r\n",
+		   NumCtrls, (u32)COUNTS_TO_US(DiscoverTime),
+		   (u32)COUNTS_TO_US(Slowest));
+	if (Ctrl == NULL) {
+		return XST_FAILURE;
+	}
+
+	Device = Ctrl->Eeprom;
+	*Eeprom_Addr = Device.SlvAddr;
+	EepromDeviceId = Ctrl->DeviceId;
+	EepromMuxAddr = Device.MuxAddr;
+	EepromMuxChannel = Device.MuxChannel;
+
+	Status = IicPsSessionOpen(Ctrl->DeviceId);
+	if ((Status == XST_SUCCESS) && (Device.MuxAddr != 0)) {
+		Status = MuxRoute(&IicInstance, &IicFlags, Device.MuxAddr,
+				  Device.MuxChannel);
+	}
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	Status = EepromGetGeometry(&IicInstance, &IicFlags, Ctrl->DeviceId,
+				   &Device);
+	if (Status != XST_SUCCESS) {
+		xil_printf("Failed to find the page size of 0X%X EEPROM\r\n", Device.SlvAddr);
+		return XST_FAILURE;
+	}
+	*Eeprom_Addr = Device.SlvAddr;
+	*PageSize = Device.PageSize;
+	EepromAddrBytes = Device.AddrBytes;
+	EepromBlockMask = Device.BlockMask;
+	EepromSize = Device.Size;
+	xil_printf("Page size %d\r\n", *PageSize);
+	xil_printf("%d bytes, %d address bytes, block select 0x%X\r\n", EepromSize, EepromAddrBytes, EepromBlockMask);
+	return XST_SUCCESS;
+}
+static int FindEepromDevice(XIicPs *IicPtr, IicPsFlags *Flags, u16 Address)
+{
+	return IicPsProbe(IicPtr, Flags, Address, ProbeTimeoutUs);
+}
+
+/*****************************************************************************/
+/**
+* This function is used to figure out page size Eeprom slave device
+*
+* Two bytes are written to the last byte of the first 64 byte page, the
+* first one unchanged and the second one a marker. The second byte rolls
+* over to the start of its page, at word address 56, 48, 32 or 0 for pages
+* of 8, 16, 32 or 64 bytes, or lands at 64 on larger pages. The first 65
+* bytes are read before and after the write to find where the marker went,
+* and the one byte it replaced is written back.
+*
+* For two byte word addresses the capacity is found with the same marker:
+* it is the smallest power of two from 4 KB on at which the word address
+* of the marker wraps around to it.
+*
+* @param	IicPtr is a pointer to the IIC driver instance of the bus.
+* @param	Device is the EEPROM, with AddrBytes set. Its PageSize is
+*		updated, and its Size too for two byte word addresses.
+*
+* @return	XST_SUCCESS if successful and also update the epprom slave
+* device pagesize else XST_FAILURE.
+*
+* @note		EepromSlvAddr must be the EEPROM. Pages larger than 64 bytes
+*		are reported as 64 bytes. The detection costs one write cycle
+*		and the restore another. If the marker write is not read back,
+*		only byte 63 is written back.
+*
+******************************************************************************/
+static int FindEepromPageSize(XIicPs *IicPtr, IicPsFlags *Flags, EepromDevice *Device)
+{
+	static const u16 WrapAddress[5] = {56, 48, 32, 0, PAGE_SIZE_64};
+	static const u32 WrapPageSize[5] = {PAGE_SIZE_8, PAGE_SIZE_16,
+					    PAGE_SIZE_32, PAGE_SIZE_64,
+					    PAGE_SIZE_64};
+	u8 Contents[PAGE_SIZE_64 + 1];
+	u8 Probed[PAGE_SIZE_64 + 1];
+	u8 Aliases[4][PAGE_SIZE_64 + 1];
+	u32 SavedAddrBytes = EepromAddrBytes;
+	u8 SavedBlockMask = EepromBlockMask;
+	u32 NumAliases = 0;
+	u32 Index, Alias, Found;
+	u32 Collision;
+	u32 MarkerSent;
+	u32 WrBfrOffset;
+	int Status;
+	u8 Marker;
+
+	EepromAddrBytes = Device->AddrBytes;
+	EepromBlockMask = 0;
+
+	Status = EepromReadSequential(IicPtr, Flags, Contents, sizeof(Contents),
+				      EEPROM_START_ADDRESS);
+
+	/*
+	 * The word addresses the marker could wrap around to, 4 KB to 32 KB
+	 * further up.
+	 */
+	if (Device->AddrBytes == 2U) {
+		NumAliases = 4;
+	}
+	for (Alias = 0; (Alias < NumAliases) && (Status == XST_SUCCESS);
+	     Alias++) {
+		Status = EepromReadSequential(IicPtr, Flags, Aliases[Alias],
+					      sizeof(Aliases[Alias]),
+					      EEPROM_START_ADDRESS +
+					      (4096U << Alias));
+	}
+	if (Status != XST_SUCCESS) {
+		EepromAddrBytes = SavedAddrBytes;
+		EepromBlockMask = SavedBlockMask;
+		return XST_FAILURE;
+	}
+
+	/*
+	 * Pick a marker none of the possible targets holds already.
+	 */
+	Marker = (u8)~Contents[0];
+	do {
+		Collision = FALSE;
+		for (Index = 0; Index < 5U; Index++) {
+			if (Contents[WrapAddress[Index]] == Marker) {
+				Collision = TRUE;
+			}
+			for (Alias = 0; Alias < NumAliases; Alias++) {
+				if (Aliases[Alias][WrapAddress[Index]] == Marker) {
+					Collision = TRUE;
+				}
+			}
 		}
+		if (Collision != FALSE) {
+			Marker++;
+		}
+	} while (Collision != FALSE);
 
-		/*
-		 * Write to the EEPROM.
-		 */
-		Status = EepromWriteData(&IicInstance, WrBfrOffset + PageSize_test);
-		if (Status != XST_SUCCESS) {
-			return XST_FAILURE;
+	WrBfrOffset = EepromFillAddress(WriteBuffer,
+					EEPROM_START_ADDRESS + PAGE_SIZE_64 - 1);
+	WriteBuffer[WrBfrOffset] = Contents[PAGE_SIZE_64 - 1];
+	WriteBuffer[WrBfrOffset + 1] = Marker;
+	GeometryDetectCount++;
+	Status = EepromSendData(IicPtr, Flags, WrBfrOffset + 2);
+	MarkerSent = (Status == XST_SUCCESS) ? TRUE : FALSE;
+	if (Status == XST_SUCCESS) {
+		Status = EepromWaitWriteCycle(IicPtr, Flags);
+	}
+	if (Status == XST_SUCCESS) {
+		Status = EepromReadSequential(IicPtr, Flags, Probed,
+					      sizeof(Probed),
+					      EEPROM_START_ADDRESS);
+	}
+
+	/*
+	 * Without the read-back there is nothing to look for the marker in.
+	 */
+	Found = 5;
+	if (Status == XST_SUCCESS) {
+		for (Found = 0; Found < 5U; Found++) {
+			if (Probed[WrapAddress[Found]] == Marker) {
+				break;
+			}
+		}
+	}
+
+	/*
+	 * The capacity is where the word address of the marker wraps.
+	 */
+	if ((Status == XST_SUCCESS) && (Found < 5U) && (NumAliases != 0U)) {
+		Device->Size = 65536U;
+		for (Alias = 0; Alias < NumAliases; Alias++) {
+			Status = EepromReadData(IicPtr, Flags, &Probed[0], 1,
+						EEPROM_START_ADDRESS +
+						(4096U << Alias) +
+						WrapAddress[Found]);
+			if ((Status != XST_SUCCESS) || (Probed[0] == Marker)) {
+				Device->Size = 4096U << Alias;
+				break;
+			}
 		}
+	}
 
+	/*
+	 * Put back the byte the marker replaced.
+	 */
+	if (Found < 5U) {
+		WrBfrOffset = EepromFillAddress(WriteBuffer,
+						EEPROM_START_ADDRESS +
+						WrapAddress[Found]);
+		WriteBuffer[WrBfrOffset] = Contents[WrapAddress[Found]];
+		if (EepromWriteData(IicPtr, Flags, WrBfrOffset + 1) !=
+		    XST_SUCCESS) {
+			Status = XST_FAILURE;
+		}
+	} else if ((Status != XST_SUCCESS) && (MarkerSent != FALSE)) {
 		/*
-		 * Read from the EEPROM.
+		 * The EEPROM took the marker write but where the marker went
+		 * is unknown. Write back byte 63, where the write started.
 		 */
-		Status = EepromReadData(&IicInstance, ReadBuffer, PageSize_test, Address);
-		if (Status != XST_SUCCESS) {
-			return XST_FAILURE;
+		WrBfrOffset = EepromFillAddress(WriteBuffer,
+						EEPROM_START_ADDRESS +
+						PAGE_SIZE_64 - 1);
+		WriteBuffer[WrBfrOffset] = Contents[PAGE_SIZE_64 - 1];
+		(void)EepromWriteData(IicPtr, Flags, WrBfrOffset + 1);
+	}
+
+	EepromAddrBytes = SavedAddrBytes;
+	EepromBlockMask = SavedBlockMask;
+	if ((Status != XST_SUCCESS) || (Found == 5U)) {
+		return XST_FAILURE;
+	}
+
+	Device->PageSize = WrapPageSize[Found];
+	return XST_SUCCESS;
+}
+
+/*****************************************************************************/
+/**
+* This function finds whether an EEPROM takes one or two word address bytes
+* and, for one byte, its block select bits and capacity.
+*
+* A two byte write of word address 0 and a marker is sent as if the EEPROM
+* took one address byte. An EEPROM that does programs the marker and stops
+* acknowledging its address for the write cycle, one that takes two address
+* bytes only moves its address pointer. While the write cycle runs, the
+* slave addresses that differ in the low bits are probed: the ones that
+* are refused as well select further 256 byte blocks of the same EEPROM.
+* The capacity of a one byte EEPROM without block select bits is 128 bytes
+* if word address 128 wraps around to the marker, 256 bytes otherwise.
+*
+* @param	IicPtr is a pointer to the IIC driver instance of the bus.
+* @param	Device is the EEPROM. Its AddrBytes and BlockMask are updated,
+*		and its Size and SlvAddr, the address of the first block, for
+*		one byte word addresses.
+*
+* @return	XST_SUCCESS if successful else XST_FAILURE.
+*
+* @note		EepromSlvAddr must be the EEPROM. A one byte EEPROM costs one
+*		write cycle and the restore of word address 0 another, a two
+*		byte EEPROM none.
+*
+******************************************************************************/
+static int FindEepromAddrWidth(XIicPs *IicPtr, IicPsFlags *Flags, EepromDevice *Device)
+{
+	u32 SavedAddrBytes = EepromAddrBytes;
+	u8 SavedBlockMask = EepromBlockMask;
+	u8 Contents[2];
+	u8 Partners = 0;
+	u32 IsBusy = FALSE;
+	u32 WrBfrOffset;
+	u32 Bit;
+	int Status;
+	u8 Marker;
+
+	EepromAddrBytes = 1;
+	EepromBlockMask = 0;
+
+	/*
+	 * Word addresses 0 and 128 of a one byte EEPROM. A two byte EEPROM
+	 * takes the address byte as an incomplete word address.
+	 */
+	Status = EepromReadData(IicPtr, Flags, &Contents[0], 1, 0x00);
+	if (Status == XST_SUCCESS) {
+		Status = EepromReadData(IicPtr, Flags, &Contents[1], 1, 0x80);
+	}
+
+	Marker = (u8)~Contents[0];
+	while ((Marker == Contents[0]) || (Marker == Contents[1])) {
+		Marker++;
+	}
+
+	if (Status == XST_SUCCESS) {
+		WrBfrOffset = EepromFillAddress(WriteBuffer, 0x00);
+		WriteBuffer[WrBfrOffset] = Marker;
+		GeometryDetectCount++;
+		Status = EepromSendData(IicPtr, Flags, WrBfrOffset + 1);
+	}
+
+	/*
+	 * Only an EEPROM running a write cycle refuses its address, and
+	 * the other block select addresses of the same EEPROM with it.
+	 */
+	if ((Status == XST_SUCCESS) &&
+	    (IicPsProbe(IicPtr, Flags, Device->SlvAddr, EEPROM_BUSY_PROBE_US) !=
+	     XST_SUCCESS)) {
+		IsBusy = TRUE;
+		for (Bit = 0; Bit < 3U; Bit++) {
+			if (IicPsProbe(IicPtr, Flags,
+				       Device->SlvAddr ^ (1U << Bit),
+				       EEPROM_BUSY_PROBE_US) == XST_SUCCESS) {
+				break;
+			}
+			Partners |= (u8)(1U << Bit);
+		}
+	}
+	if (Status == XST_SUCCESS) {
+		Status = EepromWaitWriteCycle(IicPtr, Flags);
+	}
+
+	/*
+	 * The block select addresses have to answer once the write cycle
+	 * is over, an absent slave was refused as well.
+	 */
+	for (Bit = 0; (Bit < 3U) && (Status == XST_SUCCESS); Bit++) {
+		if (((Partners & (1U << Bit)) != 0U) &&
+		    (IicPsProbe(IicPtr, Flags, Device->SlvAddr ^ (1U << Bit),
+				ProbeTimeoutUs) != XST_SUCCESS)) {
+			Partners &= (u8)((1U << Bit) - 1U);
+		}
+	}
+
+	if ((Status == XST_SUCCESS) && (IsBusy != FALSE)) {
+		Status = EepromReadData(IicPtr, Flags, &Contents[1], 1, 0x00);
+		if ((Status == XST_SUCCESS) && (Contents[1] != Marker)) {
+			IsBusy = FALSE;
+		}
+	}
+
+	if ((Status == XST_SUCCESS) && (IsBusy != FALSE)) {
+		Device->AddrBytes = 1;
+		Device->BlockMask = Partners;
+		Device->Size = 256U * ((u32)Partners + 1U);
+		if (Partners == 0U) {
+			Status = EepromReadData(IicPtr, Flags, &Contents[1], 1,
+						0x80);
+			if ((Status == XST_SUCCESS) && (Contents[1] == Marker)) {
+				Device->Size = 128;
+			}
 		}
 
 		/*
-		 * Verify the data read against the data written.
+		 * Put back word address 0.
 		 */
-		for (Index = 0; Index < PageSize_test; Index++) {
-			if (ReadBuffer[Index] == Index + i) {
-				count++;
-			}
+		WrBfrOffset = EepromFillAddress(WriteBuffer, 0x00);
+		WriteBuffer[WrBfrOffset] = Contents[0];
+		if (EepromWriteData(IicPtr, Flags, WrBfrOffset + 1) !=
+		    XST_SUCCESS) {
+			Status = XST_FAILURE;
 		}
-		if (count == PageSize_test)
-		{
+		Device->SlvAddr &= (u16)~Partners;
+	} else {
+		Device->AddrBytes = 2;
+		Device->BlockMask = 0;
+	}
+
+	EepromAddrBytes = SavedAddrBytes;
+	EepromBlockMask = SavedBlockMask;
+	return Status;
+}
+
+/*****************************************************************************/
+/**
+* This function gets the geometry of an EEPROM, the word address width, the
+* block select bits, the capacity and the page size. It is detected with
+* FindEepromAddrWidth() and FindEepromPageSize() only the first time the
+* EEPROM is seen.
+*
+* @param	IicPtr is a pointer to the IIC driver instance of the bus,
+*		with the mux channel of the EEPROM selected.
+* @param	DeviceId is the controller of the EEPROM.
+* @param	Device is the EEPROM, its geometry is updated. SlvAddr is
+*		moved to the first block of a block select EEPROM.
+*
+* @return	XST_SUCCESS if successful else XST_FAILURE.
+*
+* @note		EepromSlvAddr must be the EEPROM. Once GeometryCache is full
+*		further EEPROMs are detected every time.
+*
+******************************************************************************/
+static int EepromGetGeometry(XIicPs *IicPtr, IicPsFlags *Flags, u16 DeviceId, EepromDevice *Device)
+{
+	EepromGeometryEntry *Entry;
+	u16 SlvAddr = Device->SlvAddr;
+	int Status;
+	u32 Index;
+
+	for (Index = 0; Index < GeometryCacheCount; Index++) {
+		Entry = &GeometryCache[Index];
+		if ((Entry->DeviceId == DeviceId) &&
+		    (Entry->Device.MuxAddr == Device->MuxAddr) &&
+		    (Entry->Device.MuxChannel == Device->MuxChannel) &&
+		    (Entry->SlvAddr == SlvAddr)) {
+			*Device = Entry->Device;
 			return XST_SUCCESS;
 		}
 	}
-	return Status;
+
+	Status = FindEepromAddrWidth(IicPtr, Flags, Device);
+	if (Status == XST_SUCCESS) {
+		Status = FindEepromPageSize(IicPtr, Flags, Device);
+	}
+	if (Status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	if (GeometryCacheCount < EEPROM_GEOMETRY_CACHE_SIZE) {
+		Entry = &GeometryCache[GeometryCacheCount++];
+		Entry->DeviceId = DeviceId;
+		Entry->SlvAddr = SlvAddr;
+		Entry->Device = *Device;
+	}
+
+	return XST_SUCCESS;
 }
 
 /*****************************************************************************/
@@ -776,55 +5666,377 @@ static int FindEepromPageSize(u16 EepromAddr, u32 *PageSize_ptr)
 * @note 	None.
 *
 *******************************************************************************/
-static int IicPsSlaveMonitor(u16 Address, u16 DeviceId, u32 Int_Id)
+static int IicPsSlaveMonitor(u16 Address, u16 DeviceId)
 {
-	u32 Index;
 	int Status;
-	XIicPs *IicPtr;
 
-	SlaveResponse = FALSE;
 	/*
-	 * Initialize the IIC driver so that it is ready to use.
+	 * Set up the IIC driver, unless the probe session is on the
+	 * controller already.
 	 */
-	Status = IicPsConfig(DeviceId,Int_Id);
+	Status = IicPsSessionOpen(DeviceId);
 	if (Status != XST_SUCCESS) {
 		return XST_FAILURE;
 	}
 
-	IicPtr = &IicInstance;
-	XIicPs_DisableAllInterrupts(IicPtr->Config.BaseAddress);
-	XIicPs_EnableSlaveMonitor(&IicInstance, Address);
+	return IicPsProbe(&IicInstance, &IicFlags, Address, ProbeTimeoutUs);
+}
+
+/*****************************************************************************/
+/**
+*
+* This function checks whether a slave acknowledges its address, using the
+* slave monitor mode.
+*
+* The wait for the slave monitor interrupt is bounded by a deadline on the
+* global timer, so an absent address costs TimeoutUs whatever the CPU speed.
+* The number of probes and the time spent in them are added to ProbeCount
+* and ProbeTime.
+*
+* @param	IicPtr is a pointer to the IIC driver instance of the bus.
+* @param	Address is the address of the slave.
+* @param	TimeoutUs is the time to wait for the acknowledge in us.
+*
+* @return	XST_SUCCESS if the slave acknowledged, otherwise XST_FAILURE.
+*
+* @note 	The hardware generates NACK interrupts if the slave is not
+*		present, they are ignored.
+*
+*******************************************************************************/
+static int IicPsProbe(XIicPs *IicPtr, IicPsFlags *Flags, u16 Address, u32 TimeoutUs)
+{
+	XTime StartTime, Now, Deadline;
+	int Status = XST_FAILURE;
 
-	TotalErrorCount = 0;
+	Flags->SlaveResponse = FALSE;
+	Flags->TotalErrorCount = 0;
 
-	Index = 0;
+	XTime_GetTime(&StartTime);
+	Deadline = StartTime + US_TO_COUNTS(TimeoutUs);
+	XIicPs_DisableAllInterrupts(IicPtr->Config.BaseAddress);
+	XIicPs_EnableSlaveMonitor(IicPtr, Address);
 
 	/*
-	 * Wait for the Slave Monitor Interrupt, the interrupt processing
-	 * works in the background, this function may get locked up in this
-	 * loop if the interrupts are not working correctly or the slave
-	 * never responds.
+	 * Wait for the Slave Monitor Interrupt. An absent slave raises no
+	 * interrupt at all, the wakeup timer ends the sleep at the timeout.
 	 */
-	while ((!SlaveResponse) && (Index < SLV_MON_LOOP_COUNT)) {
-		Index++;
+	XTime_GetTime(&Now);
+	while ((Flags->SlaveResponse == FALSE) && (Now < Deadline)) {
+		Now = IicPsWaitEventUntil(Deadline);
+	}
+	if (Flags->SlaveResponse) {
+		Status = XST_SUCCESS;
+	} else {
+		Stats.Nacks++;
+	}
+
+	XIicPs_DisableSlaveMonitor(IicPtr);
+
+	ProbeCount++;
+	ProbeTime += Now - StartTime;
+	IicPsStatsAdd(IIC_STATS_PROBE, Now - StartTime);
+
+	return Status;
+}
+
+/******************************************************************************/
+
+#ifdef EEPROM_BENCHMARK
+/*****************************************************************************/
+/**
+* This function benchmarks the EEPROM paths of the example at each SCL rate
+* of BenchSClkRates[], with the workloads:
+* - discover_cold, IicPsFindEeprom() with the geometry and mux caches cleared,
+* - discover_warm, IicPsFindEeprom() with the caches of the last search,
+* - fill, sequential page writes of the whole EEPROM with EepromWrite(),
+* - verify, sequential reads of BENCH_VERIFY_CHUNK bytes, checked,
+* - write_random, EepromWrite() of 1 to BENCH_RANDOM_MAX_BYTES bytes at
+*   random addresses,
+* - read_random, EepromReadData() of 1 to BENCH_RANDOM_MAX_BYTES bytes at
+*   random addresses, checked against all the data written.
+*
+* Every workload is reported as a comma separated line starting with
+* "bench,", after a header line naming the columns, so the results of two
+* revisions can be compared with any spreadsheet or script.
+*
+* @param	None.
+*
+* @return	XST_SUCCESS if all workloads ran and read back the data
+*		written, else XST_FAILURE.
+*
+* @note		The EEPROM contents are overwritten. Compare-before-write is
+*		off while the benchmark runs, so every page write programs
+*		the EEPROM.
+*
+******************************************************************************/
+int IicPsEepromBenchmark(void)
+{
+	u8 Chunk[BENCH_VERIFY_CHUNK];
+	u32 SavedCompare = CompareBeforeWrite;
+	XTime StartTime, EndTime, OpStart;
+	u32 TestSize, ByteCount, Length;
+	u32 RateIndex, Index, Op;
+	u32 Address;
+	int Status = XST_SUCCESS;
+
+	xil_printf("bench,mode,sclk_hz,workload,ops,bytes,total_us,"
+		   "bytes_per_s,p50_us,p99_us\r\n");
+
+	CompareBeforeWrite = FALSE;
+	for (RateIndex = 0; (BenchSClkRates[RateIndex] != 0) &&
+	     (Status == XST_SUCCESS); RateIndex++) {
+		SClkRate = BenchSClkRates[RateIndex];
+
+		Status = BenchDiscovery(TRUE);
+		if (Status == XST_SUCCESS) {
+			Status = BenchDiscovery(FALSE);
+		}
+		if (Status != XST_SUCCESS) {
+			break;
+		}
+		TestSize = (EepromSize < sizeof(VerifyBuffer)) ? EepromSize :
+			   sizeof(VerifyBuffer);
 
 		/*
-		 * Ignore any errors. The hardware generates NACK interrupts
-		 * if the slave is not present.
+		 * Sequential fill, with data that differs at every rate.
 		 */
-		if (0 != TotalErrorCount) {
-			xil_printf("Test error unexpected NACK\n");
-			return XST_FAILURE;
+		for (Index = 0; Index < TestSize; Index++) {
+			VerifyBuffer[Index] = (u8)(Index + RateIndex * 0x5B);
+		}
+		XTime_GetTime(&StartTime);
+		for (Address = 0; (Address < TestSize) &&
+		     (Status == XST_SUCCESS); Address += PageSize) {
+			XTime_GetTime(&OpStart);
+			Status = EepromWrite(&IicInstance, &IicFlags,
+					     (u16)Address,
+					     &VerifyBuffer[Address], PageSize);
+			BenchRecord(OpStart);
+		}
+		XTime_GetTime(&EndTime);
+		if (Status != XST_SUCCESS) {
+			break;
+		}
+		BenchReport("fill", TestSize, EndTime - StartTime);
+
+		/*
+		 * Sequential verify.
+		 */
+		XTime_GetTime(&StartTime);
+		for (Address = 0; (Address < TestSize) &&
+		     (Status == XST_SUCCESS); Address += Length) {
+			Length = TestSize - Address;
+			if (Length > sizeof(Chunk)) {
+				Length = sizeof(Chunk);
+			}
+			XTime_GetTime(&OpStart);
+			Status = EepromReadSequential(&IicInstance, &IicFlags,
+						      Chunk, Length,
+						      (u16)Address);
+			BenchRecord(OpStart);
+			for (Index = 0; (Index < Length) &&
+			     (Status == XST_SUCCESS); Index++) {
+				if (Chunk[Index] != VerifyBuffer[Address + Index]) {
+					Status = XST_FAILURE;
+				}
+			}
+		}
+		XTime_GetTime(&EndTime);
+		if (Status != XST_SUCCESS) {
+			break;
+		}
+		BenchReport("verify", TestSize, EndTime - StartTime);
+
+		/*
+		 * Random writes, VerifyBuffer follows the EEPROM contents.
+		 */
+		ByteCount = 0;
+		XTime_GetTime(&StartTime);
+		for (Op = 0; (Op < BENCH_RANDOM_WRITES) &&
+		     (Status == XST_SUCCESS); Op++) {
+			Length = 1U + BenchRandom(BENCH_RANDOM_MAX_BYTES);
+			Address = BenchRandom(TestSize - Length + 1U);
+			for (Index = 0; Index < Length; Index++) {
+				VerifyBuffer[Address + Index] =
+					(u8)BenchRandom(256);
+			}
+			XTime_GetTime(&OpStart);
+			Status = EepromWrite(&IicInstance, &IicFlags,
+					     (u16)Address,
+					     &VerifyBuffer[Address], Length);
+			BenchRecord(OpStart);
+			ByteCount += Length;
+		}
+		XTime_GetTime(&EndTime);
+		if (Status != XST_SUCCESS) {
+			break;
+		}
+		BenchReport("write_random", ByteCount, EndTime - StartTime);
+
+		/*
+		 * Random reads.
+		 */
+		ByteCount = 0;
+		XTime_GetTime(&StartTime);
+		for (Op = 0; (Op < BENCH_RANDOM_READS) &&
+		     (Status == XST_SUCCESS); Op++) {
+			Length = 1U + BenchRandom(BENCH_RANDOM_MAX_BYTES);
+			Address = BenchRandom(TestSize - Length + 1U);
+			XTime_GetTime(&OpStart);
+			Status = EepromReadData(&IicInstance, &IicFlags,
+						ReadBuffer, (u16)Length,
+						(u16)Address);
+			BenchRecord(OpStart);
+			for (Index = 0; (Index < Length) &&
+			     (Status == XST_SUCCESS); Index++) {
+				if (ReadBuffer[Index] != VerifyBuffer[Address + Index]) {
+					Status = XST_FAILURE;
+				}
+			}
+			ByteCount += Length;
+		}
+		XTime_GetTime(&EndTime);
+		if (Status != XST_SUCCESS) {
+			break;
 		}
+		BenchReport("read_random", ByteCount, EndTime - StartTime);
 	}
 
-	if (Index >= SLV_MON_LOOP_COUNT) {
-		return XST_FAILURE;
- 
+	CompareBeforeWrite = SavedCompare;
+	SClkRate = IIC_SCLK_RATE;
+
+	return Status;
+}
+
+/*****************************************************************************/
+/**
+* This function returns a pseudo random number, from a linear congruential
+* generator, so that every run does the same operations.
+*
+* @param	Range is the number of values.
+*
+* @return	A number from 0 to Range - 1.
+*
+* @note		None.
+*
+******************************************************************************/
+static u32 BenchRandom(u32 Range)
+{
+	BenchSeed = BenchSeed * 1103515245U + 12345U;
+
+	return (BenchSeed >> 16) % Range;
+}
+
+/*****************************************************************************/
+/**
+* This function records the latency of an operation of the workload.
+*
+* @param	StartTime is the time the operation started.
+*
+* @return	None.
+*
+* @note		Operations past BENCH_MAX_OPS are not recorded.
+*
+******************************************************************************/
+static void BenchRecord(XTime StartTime)
+{
+	XTime Now;
+
+	XTime_GetTime(&Now);
+	if (BenchOps < BENCH_MAX_OPS) {
+		BenchLatency[BenchOps] = Now - StartTime;
+		BenchOps++;
 	}
+}
 
-	XIicPs_DisableSlaveMonitor(&IicInstance);
-	return XST_SUCCESS;
+/*****************************************************************************/
+/**
+* This function prints the result line of a workload and starts the next
+* one. The latency percentiles are taken by nearest rank from the sorted
+* latencies of the operations.
+*
+* @param	Workload is the name of the workload.
+* @param	ByteCount is the number of data bytes moved.
+* @param	Elapsed is the duration of the whole workload.
+*
+* @return	None.
+*
+* @note		None.
+*
+******************************************************************************/
+static void BenchReport(const char *Workload, u32 ByteCount, XTime Elapsed)
+{
+	XTime Latency;
+	u32 Index, Sorted;
+	u32 P50 = 0;
+	u32 P99 = 0;
+
+	/*
+	 * Insertion sort, the workloads are small.
+	 */
+	for (Index = 1; Index < BenchOps; Index++) {
+		Latency = BenchLatency[Index];
+		for (Sorted = Index; (Sorted > 0U) &&
+		     (BenchLatency[Sorted - 1U] > Latency); Sorted--) {
+			BenchLatency[Sorted] = BenchLatency[Sorted - 1U];
+		}
+		BenchLatency[Sorted] = Latency;
+	}
+
+	if (BenchOps != 0U) {
+		P50 = (u32)COUNTS_TO_US(BenchLatency[(BenchOps * 50U + 99U) / 100U - 1U]);
+		P99 = (u32)COUNTS_TO_US(BenchLatency[(BenchOps * 99U + 99U) / 100U - 1U]);
+	}
+
+	xil_printf("bench,intr,%d,%s,%d,%d,%d,%d,%d,%d\r\n", SClkRate,
+		   Workload, BenchOps, ByteCount, (u32)COUNTS_TO_US(Elapsed),
+		   (Elapsed == 0U) ? 0U : (u32)((u64)ByteCount *
+		   COUNTS_PER_SECOND / Elapsed), P50, P99);
+
+	BenchOps = 0;
 }
 
-/******************************************************************************/
+/*****************************************************************************/
+/**
+* This function times BENCH_DISCOVERY_RUNS searches for the EEPROM with
+* IicPsFindEeprom().
+*
+* @param	IsCold clears the detected geometries and the mux channel
+*		tracking before every search, so that it probes and detects
+*		everything again as after a reset.
+*
+* @return	XST_SUCCESS if every search found the EEPROM, else
+*		XST_FAILURE.
+*
+* @note		The controllers are set up at SClkRate by the search.
+*
+******************************************************************************/
+static int BenchDiscovery(u32 IsCold)
+{
+	XTime StartTime, EndTime, OpStart;
+	u32 Run, Index;
+	int Status = XST_SUCCESS;
+
+	XTime_GetTime(&StartTime);
+	for (Run = 0; (Run < BENCH_DISCOVERY_RUNS) && (Status == XST_SUCCESS);
+	     Run++) {
+		if (IsCold != FALSE) {
+			GeometryCacheCount = 0;
+			for (Index = 0; Index < IIC_MUX_STATE_SIZE; Index++) {
+				MuxStates[Index].MuxAddr = 0;
+			}
+		}
+		XTime_GetTime(&OpStart);
+		Status = IicPsFindEeprom(&EepromSlvAddr, &PageSize);
+		BenchRecord(OpStart);
+	}
+	XTime_GetTime(&EndTime);
+
+	if (Status == XST_SUCCESS) {
+		BenchReport((IsCold != FALSE) ? "discover_cold" : "discover_warm",
+			    0, EndTime - StartTime);
+	}
+	BenchOps = 0;
+
+	return Status;
+}
+#endif